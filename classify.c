@@ -0,0 +1,313 @@
+/**
+ * @file classify.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Linear time recognition and coloring of bipartite and chordal graphs
+ *
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "classify.h"
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Bipartite graphs
+
+/**
+ * @brief Two-colors the graph with a breadth first search from every uncolored node
+ *
+ * @param adjacency The adjacency of the graph
+ * @param colors Output for the side of every node
+ * @param queue Buffer for numNodes nodes
+ * @param components Output for the number of connected components
+ * @return true if the graph is bipartite
+ */
+static bool colorBipartite(const graph_adjacency_t *adjacency, int8_t *colors, uint32_t *queue, size_t *components) {
+    memset(colors, -1, adjacency -> numNodes);
+    *components = 0;
+    for(uint32_t root = 0; root < adjacency -> numNodes; ++root) {
+        if(colors[root] >= 0) {
+            continue;
+        }
+        ++*components;
+        colors[root] = 0;
+        size_t head = 0;
+        size_t tail = 0;
+        queue[tail++] = root;
+        while(head < tail) {
+            uint32_t node = queue[head++];
+            for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+                uint32_t neighbor = adjacency -> neighbors[i];
+                if(colors[neighbor] < 0) {
+                    colors[neighbor] = (int8_t) (1 - colors[node]);
+                    queue[tail++] = neighbor;
+                } else if(colors[neighbor] == colors[node]) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Chordal graphs
+
+/**
+ * @brief Buffers of the lexicographic breadth first search and the elimination ordering test
+ *
+ */
+typedef struct {
+    uint32_t *sequence;
+    uint32_t *position;
+    uint32_t *classOf;
+    uint32_t *classStart;
+    uint32_t *classEnd;
+    uint32_t *classSplit;
+    uint32_t *classRound;
+    uint32_t *checkOffsets;
+    uint32_t *checks;
+    uint32_t *mark;
+} lex_bfs_t;
+
+/**
+ * @brief Orders the nodes by a lexicographic breadth first search with partition refinement. The unvisited nodes form
+ *        consecutive classes of sequence, visiting a node moves its unvisited neighbors to the front of their class,
+ *        where they form a new class in front of the old one
+ */
+static void lexBfs(const graph_adjacency_t *adjacency, lex_bfs_t *lex) {
+    uint32_t numNodes = (uint32_t) adjacency -> numNodes;
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        lex -> sequence[node] = node;
+        lex -> position[node] = node;
+        lex -> classOf[node] = 0;
+    }
+    uint32_t numClasses = 1;
+    lex -> classStart[0] = 0;
+    lex -> classEnd[0] = numNodes;
+    lex -> classRound[0] = UINT32_MAX;
+
+    for(uint32_t round = 0; round < numNodes; ++round) {
+        // The first class starts at the first unvisited position
+        uint32_t node = lex -> sequence[round];
+        ++lex -> classStart[lex -> classOf[node]];
+
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            uint32_t neighbor = adjacency -> neighbors[i];
+            if(lex -> position[neighbor] <= round) {
+                continue;
+            }
+            uint32_t oldClass = lex -> classOf[neighbor];
+            if(lex -> classRound[oldClass] != round) {
+                uint32_t newClass = numClasses++;
+                lex -> classStart[newClass] = lex -> classStart[oldClass];
+                lex -> classEnd[newClass] = lex -> classStart[oldClass];
+                lex -> classRound[newClass] = UINT32_MAX;
+                lex -> classRound[oldClass] = round;
+                lex -> classSplit[oldClass] = newClass;
+            }
+            uint32_t newClass = lex -> classSplit[oldClass];
+
+            // Swap the neighbor to the front of its old class, which becomes the end of the new one
+            uint32_t front = lex -> classStart[oldClass];
+            uint32_t displaced = lex -> sequence[front];
+            lex -> sequence[lex -> position[neighbor]] = displaced;
+            lex -> position[displaced] = lex -> position[neighbor];
+            lex -> sequence[front] = neighbor;
+            lex -> position[neighbor] = front;
+            ++lex -> classStart[oldClass];
+            ++lex -> classEnd[newClass];
+            lex -> classOf[neighbor] = newClass;
+        }
+    }
+}
+
+/**
+ * @brief Checks whether the reverse of the search order is a perfect elimination ordering. For every node, its earlier
+ *        neighbors other than the latest one have to be neighbors of the latest one as well. These pairs are collected
+ *        per latest neighbor and checked with one marking pass over its neighbors, so the test stays linear
+ *
+ * @param adjacency The adjacency of the graph
+ * @param lex The buffers with the search order
+ * @param cliqueSize Output for the size of the largest clique if the graph is chordal
+ * @return true if the graph is chordal
+ */
+static bool isPerfectEliminationOrder(const graph_adjacency_t *adjacency, lex_bfs_t *lex, size_t *cliqueSize) {
+    uint32_t numNodes = (uint32_t) adjacency -> numNodes;
+    memset(lex -> checkOffsets, 0, sizeof(uint32_t) * (numNodes + 1));
+    *cliqueSize = 1;
+
+    // The latest earlier neighbor of every node is kept in classOf, which the search no longer needs
+    uint32_t *latest = lex -> classOf;
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        uint32_t earlier = 0;
+        latest[node] = UINT32_MAX;
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            uint32_t neighbor = adjacency -> neighbors[i];
+            if(lex -> position[neighbor] < lex -> position[node]) {
+                ++earlier;
+                if(latest[node] == UINT32_MAX || lex -> position[neighbor] > lex -> position[latest[node]]) {
+                    latest[node] = neighbor;
+                }
+            }
+        }
+        if(earlier + 1 > *cliqueSize) {
+            *cliqueSize = earlier + 1;
+        }
+        if(earlier > 1) {
+            lex -> checkOffsets[latest[node] + 1] += earlier - 1;
+        }
+    }
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        lex -> checkOffsets[node + 1] += lex -> checkOffsets[node];
+    }
+
+    // Fill every list from its start, which moves every offset to the start of the next list
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            uint32_t neighbor = adjacency -> neighbors[i];
+            if(lex -> position[neighbor] < lex -> position[node] && neighbor != latest[node]) {
+                lex -> checks[lex -> checkOffsets[latest[node]]++] = neighbor;
+            }
+        }
+    }
+    for(uint32_t node = numNodes; node > 0; --node) {
+        lex -> checkOffsets[node] = lex -> checkOffsets[node - 1];
+    }
+    lex -> checkOffsets[0] = 0;
+
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        lex -> mark[node] = UINT32_MAX;
+    }
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        if(lex -> checkOffsets[node] == lex -> checkOffsets[node + 1]) {
+            continue;
+        }
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            lex -> mark[adjacency -> neighbors[i]] = node;
+        }
+        for(uint32_t i = lex -> checkOffsets[node]; i < lex -> checkOffsets[node + 1]; ++i) {
+            if(lex -> mark[lex -> checks[i]] != node) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Colors a chordal graph greedily in search order. The colored neighbors of a node form a clique,
+ *        so the lowest free color is below the clique number
+ */
+static void colorChordal(const graph_adjacency_t *adjacency, const lex_bfs_t *lex, int8_t *colors) {
+    memset(colors, -1, adjacency -> numNodes);
+    for(uint32_t round = 0; round < adjacency -> numNodes; ++round) {
+        uint32_t node = lex -> sequence[round];
+        uint64_t used = 0;
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            int8_t color = colors[adjacency -> neighbors[i]];
+            if(color >= 0) {
+                used |= 1ULL << color;
+            }
+        }
+        colors[node] = (int8_t) __builtin_ctzll(~used);
+    }
+}
+
+/**
+ * @brief Frees the buffers of the search
+ */
+static void freeLexBfs(lex_bfs_t *lex) {
+    free(lex -> sequence);
+    free(lex -> position);
+    free(lex -> classOf);
+    free(lex -> classStart);
+    free(lex -> classEnd);
+    free(lex -> classSplit);
+    free(lex -> classRound);
+    free(lex -> checkOffsets);
+    free(lex -> checks);
+    free(lex -> mark);
+}
+
+/**
+ * @brief Tests whether the graph is chordal and colors it if its clique number is at most numColors
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int classifyChordal(const graph_adjacency_t *adjacency, int numColors, int8_t *colors, classification_t *classification) {
+    size_t numNodes = adjacency -> numNodes;
+    size_t numEdges = adjacency -> offsets[numNodes] / 2;
+    lex_bfs_t lex;
+    memset(&lex, 0, sizeof(lex));
+
+    // Every class but the first is split off by an edge to a later node
+    lex.sequence = malloc(sizeof(uint32_t) * numNodes);
+    lex.position = malloc(sizeof(uint32_t) * numNodes);
+    lex.classOf = malloc(sizeof(uint32_t) * numNodes);
+    lex.classStart = malloc(sizeof(uint32_t) * (numEdges + 1));
+    lex.classEnd = malloc(sizeof(uint32_t) * (numEdges + 1));
+    lex.classSplit = malloc(sizeof(uint32_t) * (numEdges + 1));
+    lex.classRound = malloc(sizeof(uint32_t) * (numEdges + 1));
+    lex.checkOffsets = malloc(sizeof(uint32_t) * (numNodes + 1));
+    lex.checks = malloc(sizeof(uint32_t) * (numEdges + 1));
+    lex.mark = malloc(sizeof(uint32_t) * numNodes);
+    if(lex.sequence == NULL || lex.position == NULL || lex.classOf == NULL || lex.classStart == NULL || lex.classEnd == NULL ||
+        lex.classSplit == NULL || lex.classRound == NULL || lex.checkOffsets == NULL || lex.checks == NULL || lex.mark == NULL) {
+        freeLexBfs(&lex);
+        return -1;
+    }
+
+    lexBfs(adjacency, &lex);
+    size_t cliqueSize;
+    if(isPerfectEliminationOrder(adjacency, &lex, &cliqueSize)) {
+        classification -> graphClass = "chordal";
+        classification -> cliqueSize = cliqueSize;
+        if(cliqueSize > (size_t) numColors) {
+            classification -> verdict = VERDICT_UNCOLORABLE;
+        } else {
+            colorChordal(adjacency, &lex, colors);
+            classification -> verdict = VERDICT_COLORABLE;
+        }
+    }
+
+    freeLexBfs(&lex);
+    return 0;
+}
+
+int classifyGraph(const graph_adjacency_t *adjacency, int numColors, int8_t *colors, classification_t *classification) {
+    size_t numNodes = adjacency -> numNodes;
+    size_t numEdges = adjacency -> offsets[numNodes] / 2;
+    classification -> verdict = VERDICT_UNKNOWN;
+    classification -> graphClass = NULL;
+    classification -> cliqueSize = 0;
+
+    if(numEdges == 0) {
+        memset(colors, 0, numNodes);
+        classification -> graphClass = "edgeless";
+        classification -> cliqueSize = numNodes > 0 ? 1 : 0;
+        classification -> verdict = numColors >= 1 || numNodes == 0 ? VERDICT_COLORABLE : VERDICT_UNCOLORABLE;
+        return 0;
+    }
+
+    uint32_t *queue = malloc(sizeof(uint32_t) * numNodes);
+    if(queue == NULL) {
+        return -1;
+    }
+    size_t components;
+    bool bipartite = colorBipartite(adjacency, colors, queue, &components);
+    free(queue);
+    if(bipartite) {
+        // A bipartite graph without cycles has one edge less than nodes per component
+        classification -> graphClass = numEdges + components == numNodes ? "forest" : "bipartite";
+        classification -> cliqueSize = 2;
+        classification -> verdict = numColors >= 2 ? VERDICT_COLORABLE : VERDICT_UNCOLORABLE;
+        return 0;
+    }
+
+    return classifyChordal(adjacency, numColors, colors, classification);
+}
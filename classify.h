@@ -0,0 +1,45 @@
+/**
+ * @file classify.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the recognition of graph classes that are colored exactly in linear time
+ * @details A breadth first search two-colors bipartite graphs, forests among them. Otherwise a lexicographic breadth
+ *          first search orders the nodes, and if the reverse of that order is a perfect elimination ordering the graph
+ *          is chordal. The earlier neighbors of every node in the search order then form a clique, so the largest of
+ *          them gives the clique number, and coloring greedily in search order uses no more colors than that.
+ *
+ **/
+
+#ifndef CLASSIFY_H_FILE
+#define CLASSIFY_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "commons.h"
+#include "graph.h"
+
+/**
+ * @brief Result of the classification of a graph
+ *
+ */
+typedef struct {
+    int verdict;
+    const char *graphClass;
+    size_t cliqueSize;
+} classification_t;
+
+/**
+ * @brief Classifies a graph and colors it if it belongs to one of the recognised classes
+ *
+ * @param adjacency The adjacency of the graph
+ * @param numColors The number of colors
+ * @param colors Output for the color of every node if the verdict is VERDICT_COLORABLE
+ * @param classification Output for the verdict, the name of the class or NULL and, for chordal graphs, the clique number
+ * @return 0 on success, -1 with errno set on failure
+ */
+int classifyGraph(const graph_adjacency_t *adjacency, int numColors, int8_t *colors, classification_t *classification);
+
+#endif
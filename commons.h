@@ -19,19 +19,152 @@
 
 #include <semaphore.h>
 #include <stdbool.h>
+#include <sys/types.h>
+#include <stdint.h>
 
 #define MAX_NUM_RESULT_SETS 10
 #define MAX_NUM_EDGES_RESULT_SET 10
 
+#define CACHE_LINE_SIZE 64
+#define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE_SIZE)))
+#define HUGE_PAGE_SIZE (2UL * 1024UL * 1024UL)
+
+#define MAX_NUM_WORKERS 64
+#define NUM_STRATEGIES 11
+
+#define CONSTRUCTION_UNIFORM 0
+#define CONSTRUCTION_DSATUR 1
+#define CONSTRUCTION_RLF 2
+
+#define MAX_NUM_GRAPH_DELTAS 4096
+#define GRAPH_DELTA_ADD 1
+#define GRAPH_DELTA_REMOVE 2
+
+#define COLORING_FILTER_BITS (1UL << 23)
+#define COLORING_FILTER_HASHES 4
+
+#define VERDICT_UNKNOWN 0
+#define VERDICT_COLORABLE 1
+#define VERDICT_UNCOLORABLE 2
+
+#define EDGE_WEIGHT_TABLE_SIZE (1UL << 16)
+#define EDGE_WEIGHT_MAX 4
+
 /**
- * @brief Structure to keep circular buffer data and stop generators signal
+ * @brief One slot of the circular buffer. Every slot starts on its own cache line,
+ *        so a generator filling one slot never invalidates the slot the supervisor is reading.
+ *        verdict is one of the VERDICT_ values, VERDICT_UNCOLORABLE marks a proof that no coloring exists
+ * 
+ */
+typedef struct {
+    long edges[MAX_NUM_EDGES_RESULT_SET][2];
+    int worker;
+    int strategy;
+    int verdict;
+    uint64_t graphVersion;
+} CACHE_ALIGNED result_set_t;
+
+/**
+ * @brief Flags written by the supervisor and polled by the generators
  * 
  */
 typedef struct {
-    long resultSets[MAX_NUM_RESULT_SETS][MAX_NUM_EDGES_RESULT_SET][2];
-    int readPos;
-    int writePos;
     bool stopGenerators;
+    bool lockMemory;
+    int numColors;
+    int numWorkers;
+} CACHE_ALIGNED control_flags_t;
+
+/**
+ * @brief Search configuration a generator can be assigned to. construction is one of the CONSTRUCTION_ values
+ *        and selects how every sample or restart coloring is drawn
+ * 
+ */
+typedef struct {
+    long restartInterval;
+    int samplingBias;
+    int seedStream;
+    int construction;
+} strategy_config_t;
+
+/**
+ * @brief Control word of one registered generator. The supervisor writes the strategy, the generator polls it between batches
+ * 
+ */
+typedef struct {
+    int strategy;
+    bool active;
+    pid_t pid;
+} CACHE_ALIGNED worker_slot_t;
+
+/**
+ * @brief One change of the graph
+ * 
+ */
+typedef struct {
+    long nodes[2];
+    int operation;
+} graph_delta_t;
+
+/**
+ * @brief Ring of graph changes. Delta i lives in deltas[i % MAX_NUM_GRAPH_DELTAS], version is the number of published deltas.
+ *        The supervisor is the only writer and publishes a delta by incrementing version after writing it,
+ *        generators apply all deltas up to version between batches
+ * 
+ */
+typedef struct {
+    uint64_t version CACHE_ALIGNED;
+    graph_delta_t deltas[MAX_NUM_GRAPH_DELTAS] CACHE_ALIGNED;
+} graph_delta_log_t;
+
+/**
+ * @brief Bloom filter of the colorings the generators reported, keyed by a hash that is the same for all colorings
+ *        that only differ by a permutation of the colors. Bits are only ever set, with atomic or, by any generator.
+ *        The counters let the supervisor report how much duplicate work the filter removed
+ * 
+ */
+typedef struct {
+    uint64_t inserted CACHE_ALIGNED;
+    uint64_t duplicateResults CACHE_ALIGNED;
+    uint64_t skippedEvaluations CACHE_ALIGNED;
+    uint64_t bits[COLORING_FILTER_BITS / 64] CACHE_ALIGNED;
+} coloring_filter_t;
+
+/**
+ * @brief Weight of one edge, keyed by the ids of its endpoints with the smaller id first. Unused entries have the ids -1
+ * 
+ */
+typedef struct {
+    long nodes[2];
+    uint32_t weight;
+} edge_weight_entry_t;
+
+/**
+ * @brief Open addressing table of the edge weights the supervisor derives from the conflicts in the results.
+ *        The supervisor is the only writer and guards every publication with the sequence like a seqlock,
+ *        it is odd while the entries are written. Edges without an entry have weight 1
+ * 
+ */
+typedef struct {
+    uint64_t sequence CACHE_ALIGNED;
+    edge_weight_entry_t entries[EDGE_WEIGHT_TABLE_SIZE] CACHE_ALIGNED;
+} edge_weight_table_t;
+
+/**
+ * @brief Structure to keep circular buffer data and stop generators signal.
+ *        The producer index, the consumer index, the control flags and every slot live on separate cache lines.
+ * 
+ */
+typedef struct {
+    int writePos CACHE_ALIGNED;
+    int readPos CACHE_ALIGNED;
+    control_flags_t control;
+    strategy_config_t strategies[NUM_STRATEGIES] CACHE_ALIGNED;
+    worker_slot_t workers[MAX_NUM_WORKERS];
+    result_set_t resultSets[MAX_NUM_RESULT_SETS];
+    graph_delta_log_t deltaLog;
+    coloring_filter_t coloringFilter;
+    edge_weight_table_t edgeWeights;
 } circular_buffer_data_t;
 
 /**
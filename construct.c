@@ -0,0 +1,276 @@
+/**
+ * @file construct.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Randomized greedy constructions of colorings
+ *
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "construct.h"
+
+int constructCreate(construct_t *construct, const graph_adjacency_t *adjacency, int numColors) {
+    memset(construct, 0, sizeof(*construct));
+    size_t numNodes = adjacency -> numNodes > 0 ? adjacency -> numNodes : 1;
+    construct -> adjacency = adjacency;
+    construct -> numColors = numColors;
+    construct -> colors = malloc(numNodes);
+    construct -> neighborColors = malloc(sizeof(uint32_t) * KERNEL_MAX_COLORS * numNodes);
+    construct -> order = malloc(sizeof(uint32_t) * numNodes);
+    construct -> position = malloc(sizeof(uint32_t) * numNodes);
+    construct -> candidates = malloc(sizeof(uint64_t) * ((numNodes + 63) / 64));
+    construct -> excludedNeighbors = malloc(sizeof(uint32_t) * numNodes);
+    construct -> uncoloredDegree = malloc(sizeof(uint32_t) * numNodes);
+    if(construct -> colors == NULL || construct -> neighborColors == NULL || construct -> order == NULL || construct -> position == NULL ||
+        construct -> candidates == NULL || construct -> excludedNeighbors == NULL || construct -> uncoloredDegree == NULL) {
+        constructFree(construct);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Clears the coloring and the neighbor color counts
+ */
+static void resetColoring(construct_t *construct) {
+    memset(construct -> colors, -1, construct -> adjacency -> numNodes);
+    memset(construct -> neighborColors, 0, sizeof(uint32_t) * KERNEL_MAX_COLORS * construct -> adjacency -> numNodes);
+}
+
+/**
+ * @brief Returns the lowest color no neighbor of the node has, or a random one of the colors the fewest neighbors have
+ */
+static int leastConflictingColor(const construct_t *construct, uint32_t node, rng_state_t *rng) {
+    const uint32_t *counts = &construct -> neighborColors[(size_t) node * KERNEL_MAX_COLORS];
+    int best = 0;
+    uint32_t ties = 0;
+    for(int color = 0; color < construct -> numColors; ++color) {
+        if(counts[color] == 0) {
+            return color;
+        }
+        if(counts[color] < counts[best]) {
+            best = color;
+            ties = 1;
+        } else if(counts[color] == counts[best] && rngBelow(rng, ++ties) == 0) {
+            best = color;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Colors a node and counts the color at all of its neighbors
+ */
+static void assignColor(construct_t *construct, uint32_t node, int color) {
+    const graph_adjacency_t *adjacency = construct -> adjacency;
+    construct -> colors[node] = (int8_t) color;
+    for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+        ++construct -> neighborColors[(size_t) adjacency -> neighbors[i] * KERNEL_MAX_COLORS + color];
+    }
+}
+
+/**
+ * @brief Copies the constructed coloring into the kernel
+ */
+static void writeColoring(const construct_t *construct, kernel_t *kernel) {
+    for(size_t node = 0; node < construct -> adjacency -> numNodes; ++node) {
+        kernelSetColor(kernel, node, construct -> colors[node]);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// DSATUR
+
+/**
+ * @brief Swaps two entries of the bucket queue
+ */
+static void swapOrder(construct_t *construct, uint32_t first, uint32_t second) {
+    uint32_t firstNode = construct -> order[first];
+    uint32_t secondNode = construct -> order[second];
+    construct -> order[first] = secondNode;
+    construct -> order[second] = firstNode;
+    construct -> position[secondNode] = first;
+    construct -> position[firstNode] = second;
+}
+
+void constructDsatur(void *context, kernel_t *kernel, rng_state_t *rng) {
+    construct_t *construct = context;
+    const graph_adjacency_t *adjacency = construct -> adjacency;
+    int numColors = construct -> numColors;
+    resetColoring(construct);
+
+    // order holds the uncolored nodes sorted by saturation, bucket s is order[bucketStart[s]] to order[bucketStart[s + 1] - 1]
+    uint32_t bucketStart[KERNEL_MAX_COLORS + 2];
+    uint32_t remaining = (uint32_t) adjacency -> numNodes;
+    for(uint32_t node = 0; node < remaining; ++node) {
+        construct -> order[node] = node;
+        construct -> position[node] = node;
+    }
+    bucketStart[0] = 0;
+    for(int saturation = 1; saturation <= numColors + 1; ++saturation) {
+        bucketStart[saturation] = remaining;
+    }
+
+    while(remaining > 0) {
+        // The most saturated nodes are the last bucket, any of them is picked with the same probability
+        int top = numColors;
+        while(bucketStart[top] == bucketStart[top + 1]) {
+            --top;
+        }
+        uint32_t index = bucketStart[top] + rngBelow(rng, bucketStart[top + 1] - bucketStart[top]);
+        uint32_t node = construct -> order[index];
+        swapOrder(construct, index, --remaining);
+        for(int saturation = 1; saturation <= numColors + 1; ++saturation) {
+            if(bucketStart[saturation] > remaining) {
+                bucketStart[saturation] = remaining;
+            }
+        }
+
+        int color = leastConflictingColor(construct, node, rng);
+        construct -> colors[node] = (int8_t) color;
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            uint32_t neighbor = adjacency -> neighbors[i];
+            uint32_t *counts = &construct -> neighborColors[(size_t) neighbor * KERNEL_MAX_COLORS];
+            if(counts[color]++ > 0 || construct -> colors[neighbor] >= 0) {
+                continue;
+            }
+
+            // The neighbor sees a new color and moves from the end of its bucket to the start of the next one
+            int saturation = -1;
+            for(int other = 0; other < numColors; ++other) {
+                saturation += counts[other] > 0;
+            }
+            swapOrder(construct, construct -> position[neighbor], bucketStart[saturation + 1] - 1);
+            --bucketStart[saturation + 1];
+        }
+    }
+
+    writeColoring(construct, kernel);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Recursive largest first
+
+/**
+ * @brief Returns a candidate with the highest score, picked uniformly among all with that score
+ */
+static uint32_t pickCandidate(const construct_t *construct, const uint32_t *score, rng_state_t *rng) {
+    size_t numWords = (construct -> adjacency -> numNodes + 63) / 64;
+    uint32_t best = 0;
+    uint32_t bestScore = 0;
+    uint32_t ties = 0;
+    for(size_t word = 0; word < numWords; ++word) {
+        for(uint64_t bits = construct -> candidates[word]; bits != 0; bits &= bits - 1) {
+            uint32_t node = (uint32_t) (word * 64 + (size_t) __builtin_ctzll(bits));
+            if(ties == 0 || score[node] > bestScore) {
+                best = node;
+                bestScore = score[node];
+                ties = 1;
+            } else if(score[node] == bestScore && rngBelow(rng, ++ties) == 0) {
+                best = node;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Whether a node is still a candidate for the current color
+ */
+static inline bool isCandidate(const construct_t *construct, uint32_t node) {
+    return (construct -> candidates[node >> 6] >> (node & 63)) & 1;
+}
+
+/**
+ * @brief Removes a node from the candidates
+ */
+static inline void removeCandidate(construct_t *construct, uint32_t node) {
+    construct -> candidates[node >> 6] &= ~(1ULL << (node & 63));
+}
+
+void constructRlf(void *context, kernel_t *kernel, rng_state_t *rng) {
+    construct_t *construct = context;
+    const graph_adjacency_t *adjacency = construct -> adjacency;
+    uint32_t numNodes = (uint32_t) adjacency -> numNodes;
+    if(numNodes > CONSTRUCT_MAX_RLF_NODES) {
+        constructDsatur(context, kernel, rng);
+        return;
+    }
+    resetColoring(construct);
+
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        construct -> uncoloredDegree[node] = adjacency -> offsets[node + 1] - adjacency -> offsets[node];
+    }
+
+    uint32_t uncolored = numNodes;
+    for(int color = 0; color < construct -> numColors && uncolored > 0; ++color) {
+        // Every uncolored node starts as a candidate for the color
+        memset(construct -> candidates, 0, sizeof(uint64_t) * ((numNodes + 63) / 64));
+        memset(construct -> excludedNeighbors, 0, sizeof(uint32_t) * numNodes);
+        uint32_t numCandidates = 0;
+        for(uint32_t node = 0; node < numNodes; ++node) {
+            if(construct -> colors[node] < 0) {
+                construct -> candidates[node >> 6] |= 1ULL << (node & 63);
+                ++numCandidates;
+            }
+        }
+
+        // The set starts with a node of the highest degree among the uncolored nodes
+        const uint32_t *score = construct -> uncoloredDegree;
+        while(numCandidates > 0) {
+            uint32_t node = pickCandidate(construct, score, rng);
+            assignColor(construct, node, color);
+            removeCandidate(construct, node);
+            --numCandidates;
+            --uncolored;
+
+            // Neighbors can no longer join the set, candidates next to them gain an excluded neighbor
+            for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+                uint32_t neighbor = adjacency -> neighbors[i];
+                --construct -> uncoloredDegree[neighbor];
+                if(!isCandidate(construct, neighbor)) {
+                    continue;
+                }
+                removeCandidate(construct, neighbor);
+                --numCandidates;
+                for(uint32_t n = adjacency -> offsets[neighbor]; n < adjacency -> offsets[neighbor + 1]; ++n) {
+                    ++construct -> excludedNeighbors[adjacency -> neighbors[n]];
+                }
+            }
+            score = construct -> excludedNeighbors;
+        }
+    }
+
+    // Nodes left over after the last color go to their least conflicting color in random order
+    uint32_t numLeft = 0;
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        if(construct -> colors[node] < 0) {
+            construct -> order[numLeft++] = node;
+        }
+    }
+    for(uint32_t i = 0; i < numLeft; ++i) {
+        uint32_t pick = i + rngBelow(rng, numLeft - i);
+        uint32_t node = construct -> order[pick];
+        construct -> order[pick] = construct -> order[i];
+        construct -> order[i] = node;
+        assignColor(construct, node, leastConflictingColor(construct, node, rng));
+    }
+
+    writeColoring(construct, kernel);
+}
+
+void constructFree(construct_t *construct) {
+    free(construct -> colors);
+    free(construct -> neighborColors);
+    free(construct -> order);
+    free(construct -> position);
+    free(construct -> candidates);
+    free(construct -> excludedNeighbors);
+    free(construct -> uncoloredDegree);
+    memset(construct, 0, sizeof(*construct));
+}
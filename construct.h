@@ -0,0 +1,82 @@
+/**
+ * @file construct.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the randomized greedy constructions of colorings
+ * @details DSATUR colors the node with the most distinct colors among its neighbors next, picked uniformly among all
+ *          nodes of that saturation from a bucket queue. Recursive largest first builds one maximal independent set per
+ *          color, each time adding the candidate with the most neighbors that can no longer join the set.
+ *          Both give a node the lowest color none of its neighbors has, or the color with the fewest conflicts
+ *          once all are taken, so a coloring starts with few conflicts instead of about a third of the edges.
+ *
+ **/
+
+#ifndef CONSTRUCT_H_FILE
+#define CONSTRUCT_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+#include "kernel.h"
+#include "rng.h"
+
+/**
+ * @brief Larger graphs use DSATUR instead of recursive largest first, whose candidate scans grow quadratically
+ */
+#define CONSTRUCT_MAX_RLF_NODES 16384
+
+/**
+ * @brief Buffers of the constructions for one graph
+ *
+ */
+typedef struct {
+    const graph_adjacency_t *adjacency;
+    int numColors;
+    int8_t *colors;
+    uint32_t *neighborColors;
+    uint32_t *order;
+    uint32_t *position;
+    uint64_t *candidates;
+    uint32_t *excludedNeighbors;
+    uint32_t *uncoloredDegree;
+} construct_t;
+
+/**
+ * @brief Allocates the buffers of the constructions
+ *
+ * @param construct The construction state to initialise
+ * @param adjacency The adjacency of the graph, has to outlive the construction state
+ * @param numColors The number of colors, KERNEL_MIN_COLORS to KERNEL_MAX_COLORS
+ * @return 0 on success, -1 with errno set on failure
+ */
+int constructCreate(construct_t *construct, const graph_adjacency_t *adjacency, int numColors);
+
+/**
+ * @brief Builds a randomized DSATUR coloring into the kernel, a kernel_construct_t
+ *
+ * @param context The construction state
+ * @param kernel The kernel whose coloring is overwritten
+ * @param rng The random stream for the ties
+ */
+void constructDsatur(void *context, kernel_t *kernel, rng_state_t *rng);
+
+/**
+ * @brief Builds a randomized recursive largest first coloring into the kernel, a kernel_construct_t
+ *
+ * @param context The construction state
+ * @param kernel The kernel whose coloring is overwritten
+ * @param rng The random stream for the ties
+ */
+void constructRlf(void *context, kernel_t *kernel, rng_state_t *rng);
+
+/**
+ * @brief Frees the buffers of the constructions
+ *
+ * @param construct The construction state to free
+ */
+void constructFree(construct_t *construct);
+
+#endif
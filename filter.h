@@ -0,0 +1,74 @@
+/**
+ * @file filter.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Lookup and insertion for the shared Bloom filter of reported colorings
+ * @details The COLORING_FILTER_HASHES bit positions of a key are derived from its two 32 bit halves by double hashing.
+ *          Bits are read and set with relaxed atomics, a concurrent insert can at worst make a lookup miss a key,
+ *          which only costs a duplicate evaluation.
+ *
+ **/
+
+#ifndef FILTER_H_FILE
+#define FILTER_H_FILE
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "commons.h"
+
+/**
+ * @brief Returns the bit position of the round-th hash of a key
+ *
+ * @param key The key
+ * @param round The number of the hash, 0 to COLORING_FILTER_HASHES - 1
+ * @return A bit index below COLORING_FILTER_BITS
+ */
+static inline uint64_t filterBit(uint64_t key, uint64_t round) {
+    // An odd step visits different positions for every round
+    uint64_t step = (key >> 32) | 1;
+    return ((key & 0xFFFFFFFFULL) + round * step) & (COLORING_FILTER_BITS - 1);
+}
+
+/**
+ * @brief Checks whether a key may have been inserted
+ *
+ * @param filter The filter
+ * @param key The key
+ * @return false if the key was certainly not inserted
+ */
+static inline bool filterContains(const coloring_filter_t *filter, uint64_t key) {
+    for(uint64_t round = 0; round < COLORING_FILTER_HASHES; ++round) {
+        uint64_t bit = filterBit(key, round);
+        if((__atomic_load_n(&filter -> bits[bit >> 6], __ATOMIC_RELAXED) & (1ULL << (bit & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Inserts a key and counts it if it is new
+ *
+ * @param filter The filter
+ * @param key The key
+ * @return true if the key was not in the filter before
+ */
+static inline bool filterInsert(coloring_filter_t *filter, uint64_t key) {
+    bool inserted = false;
+    for(uint64_t round = 0; round < COLORING_FILTER_HASHES; ++round) {
+        uint64_t bit = filterBit(key, round);
+        uint64_t mask = 1ULL << (bit & 63);
+        if((__atomic_fetch_or(&filter -> bits[bit >> 6], mask, __ATOMIC_RELAXED) & mask) == 0) {
+            inserted = true;
+        }
+    }
+    if(inserted) {
+        __atomic_fetch_add(&filter -> inserted, 1, __ATOMIC_RELAXED);
+    }
+    return inserted;
+}
+
+#endif
@@ -22,11 +22,40 @@
 #include <limits.h>
 #include <getopt.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <fcntl.h> 
 #include <signal.h>
 #include <time.h>
+#include <stdint.h>
 
 #include "commons.h"
+#include "graph.h"
+#include "kernel.h"
+#include "repair.h"
+#include "construct.h"
+#include "classify.h"
+#include "treedp.h"
+#include "tempering.h"
+#include "independent.h"
+#include "weights.h"
+#include "rng.h"
+#include "transport.h"
+#include "trace.h"
+
+/**
+ * @brief Number of colorings a kernel samples before the generator checks the stop conditions again
+ */
+#define SEARCH_BATCH_ITERATIONS 1024
+
+/**
+ * @brief Number of moves the coldest level of the parallel tempering runs before the generator checks the stop conditions again
+ */
+#define TEMPERING_BATCH_MOVES 65536
+
+/**
+ * @brief Time the generator sleeps between two looks at the independent set search
+ */
+#define INDEPENDENT_POLL_INTERVAL_NS 10000000L
 
 /**
  * Program name
@@ -45,6 +74,11 @@ static volatile sig_atomic_t quitSignalRecieved = false;
 */
 static circular_buffer_data_t *circularBufferData = NULL;
 
+/**
+ * @brief Size of the mapped shared memory segment as created by the supervisor
+ */
+static size_t sharedMemorySize = 0;
+
 /**
  * @brief Collection of sem_t pointers for all relevant semaphores
  */
@@ -54,11 +88,116 @@ static semaphore_colleciton_t semaphoreCollection = {
     NULL,
 };
 
+/**
+ * @brief The graph with dense node indices
+ */
+static graph_t graph;
+
+/**
+ * @brief The specialised kernel bound to graph
+ */
+static kernel_t kernel;
+
+/**
+ * @brief Adjacency of graph for the repair and the constructions
+ */
+static graph_adjacency_t adjacency;
+
+/**
+ * @brief Kempe chain repair of the colorings the kernel finds
+ */
+static repair_t repair;
+
+/**
+ * @brief Greedy constructions the kernel draws its colorings with if the strategy asks for them
+ */
+static construct_t construct;
+
+/**
+ * @brief Number of replicas of the parallel tempering search, 0 if the generator searches with the kernel
+ */
+static int numReplicas = 0;
+
+/**
+ * @brief The parallel tempering search if numReplicas is set
+ */
+static tempering_t tempering;
+
+/**
+ * @brief Number of threads of the independent set search, 0 if the generator searches with the kernel
+ */
+static int numIndependentThreads = 0;
+
+/**
+ * @brief The independent set search if numIndependentThreads is set
+ */
+static independent_t independent;
+
+/**
+ * @brief Whether the verdict of the independent set search on the current graph was reported
+ */
+static bool independentReported = false;
+
+/**
+ * @brief Weight of every edge of graph as last copied from the supervisor, NULL until the first copy
+ */
+static uint8_t *edgeWeights = NULL;
+
+/**
+ * @brief Buffer the next publication is copied into, swapped with edgeWeights once the copy is consistent
+ */
+static uint8_t *loadingEdgeWeights = NULL;
+
+/**
+ * @brief Sequence of the publication edgeWeights was copied from
+ */
+static uint64_t edgeWeightSequence = 0;
+
+/**
+ * @brief Random stream of this generator
+ */
+static rng_state_t rng;
+
+/**
+ * @brief Seed of this generator, combined with the seed stream of the assigned strategy
+ */
+static uint64_t baseSeed;
+
+/**
+ * @brief Index of the worker slot of this generator in the shared memory, -1 if it is not registered
+ */
+static int workerId = -1;
+
+/**
+ * @brief Strategy the kernel is currently configured with, -1 if none was applied yet
+ */
+static int currentStrategy = -1;
+
+/**
+ * @brief Number of deltas of the graph update log applied to graph and kernel
+ */
+static uint64_t graphVersion = 0;
+
+/**
+ * @brief Socket to the supervisor if the generator runs remotely, -1 if it uses the shared memory
+ */
+static int remoteFd = -1;
+
+/**
+ * @brief Search parameters the supervisor sent to this remote generator
+ */
+static transport_hello_t remoteHello;
+
 /**
  * @brief Function declaration of cleanup function which tries to deallcoate all allocated resources
  */
 static void cleanup(void);
 
+/**
+ * @brief Function declaration of the function freeing the graph and the kernel
+ */
+static void freeAllocatedResources(void);
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Logging
 
@@ -89,7 +228,7 @@ static void printStderrCleaupAndExit(const char *output, ...) {
  * @details global variables: PROGRAM_NAME 
  */
 static void printUsageAndExit(void) {
-    printStderrCleaupAndExit("Usage: %s EDGE1...\nEdges: {node1}-{node2}", PROGRAM_NAME);
+    printStderrCleaupAndExit("Usage: %s [-T traceprefix] [-P replicas | -I threads] [-f graphfile] EDGE1...\n       %s [-T traceprefix] [-P replicas | -I threads] -c host:port\nEdges: {node1}-{node2}\nGraph files: one edge per line as {node1} {node2} or DIMACS e {node1} {node2}\n", PROGRAM_NAME, PROGRAM_NAME);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -98,61 +237,137 @@ static void printUsageAndExit(void) {
 /**
  * Parse arguments function
  * 
- * @brief This function parses the arguments given to the program via argc and argv. If something is not right it prints an eror message and exits with EXIT_FAILURE
- * @details global variables: PROGRAM_NAME
+ * @brief This function parses the arguments given to the program via argc and argv and loads the graph either from the
+ *        edges on the command line or from a graph file. With -c the graph is received from the supervisor later instead.
+ *        With -T event tracing is enabled. -P and -I pick the parallel tempering or the independent set search.
+ *        If something is not right it prints an eror message and exits with EXIT_FAILURE
+ * @details global variables: PROGRAM_NAME, graph
  * 
  * @param argc The argument counter
  * @param argv The argument vector
- * @return A pointer to an allocated two dimensional array of the edges in the graph
+ * @return The supervisor address passed with -c or NULL if the generator uses the shared memory
  */
-static long** parseArguments(int argc, char **argv) {
-    if(argc <= 1) {
+static const char* parseArguments(int argc, char **argv) {
+    const char *graphFile = NULL;
+    const char *remoteAddress = NULL;
+    const char *tracePrefix = NULL;
+    int option;
+    while ((option = getopt(argc, argv, ":f:c:P:I:T:")) != -1) {
+        switch (option) {
+            case 'P': {
+                if (numReplicas != 0) {
+                    fprintf(stderr, "[%s] ERROR: multiple replica counts were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                char *endptr;
+                long replicas = strtol(optarg, &endptr, 10);
+                if (endptr == optarg || *endptr != '\0' || replicas < 2 || replicas > TEMPERING_MAX_REPLICAS) {
+                    fprintf(stderr, "[%s] ERROR: Replicas have to be a number between 2 and %d!\n", PROGRAM_NAME, TEMPERING_MAX_REPLICAS);
+                    printUsageAndExit();
+                }
+                numReplicas = (int) replicas;
+                break;
+            }
+            case 'I': {
+                if (numIndependentThreads != 0) {
+                    fprintf(stderr, "[%s] ERROR: multiple independent set thread counts were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                char *endptr;
+                long threads = strtol(optarg, &endptr, 10);
+                if (endptr == optarg || *endptr != '\0' || threads < 1 || threads > INDEPENDENT_MAX_THREADS) {
+                    fprintf(stderr, "[%s] ERROR: Independent set threads have to be a number between 1 and %d!\n", PROGRAM_NAME, INDEPENDENT_MAX_THREADS);
+                    printUsageAndExit();
+                }
+                numIndependentThreads = (int) threads;
+                break;
+            }
+            case 'T':
+                if (tracePrefix != NULL) {
+                    fprintf(stderr, "[%s] ERROR: multiple trace prefixes were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                tracePrefix = optarg;
+                break;
+            case 'c':
+                if (remoteAddress != NULL) {
+                    fprintf(stderr, "[%s] ERROR: multiple supervisor addresses were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                remoteAddress = optarg;
+                break;
+            case 'f':
+                if (graphFile != NULL) {
+                    fprintf(stderr, "[%s] ERROR: multiple graph files were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                graphFile = optarg;
+                break;
+            case ':':
+                fprintf(stderr, "[%s] ERROR: Option -%c requires a value!\n", PROGRAM_NAME, optopt);
+                printUsageAndExit();
+                break;
+            case '?':
+            default:
+                fprintf(stderr, "[%s] ERROR: Unknown option: -%c\n", PROGRAM_NAME, optopt);
+                printUsageAndExit();
+                break;
+        }
+    }
+
+    if(numReplicas != 0 && numIndependentThreads != 0) {
+        fprintf(stderr, "[%s] ERROR: The parallel tempering and the independent set search cannot be combined!\n", PROGRAM_NAME);
         printUsageAndExit();
     }
 
-    long **buffer;
-    if((buffer = malloc(sizeof(long*) * (argc - 1))) == NULL) {
-        printStderrCleaupAndExit("[%s] ERROR: Failed to allocate buffer: %s\n", PROGRAM_NAME, strerror(errno));
+    char traceError[TRACE_ERROR_SIZE];
+    if(tracePrefix != NULL && traceOpen(tracePrefix, "generator", traceError) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, traceError);
     }
-    for(int i = 0; i < (argc - 1); ++i) {
-        if((buffer[i] = malloc(sizeof(long) * 2)) == NULL) {
-            printStderrCleaupAndExit("[%s] ERROR: Failed to allocate buffer: %s\n", PROGRAM_NAME, strerror(errno));
+
+    int numEdges = argc - optind;
+    if(remoteAddress != NULL) {
+        if(graphFile != NULL || numEdges > 0) {
+            fprintf(stderr, "[%s] ERROR: Remote generators receive the graph from the supervisor!\n", PROGRAM_NAME);
+            printUsageAndExit();
         }
+        return remoteAddress;
+    }
+    if(graphFile != NULL && numEdges > 0) {
+        fprintf(stderr, "[%s] ERROR: Edges cannot be passed together with a graph file!\n", PROGRAM_NAME);
+        printUsageAndExit();
+    }
+    if(graphFile == NULL && numEdges == 0) {
+        printUsageAndExit();
     }
 
-    for(int i = 1; i < argc; ++i) {
-        char *numb = strtok(argv[i], "-");
-        if(numb == NULL) {
-            printStderrCleaupAndExit("[%s] ERROR: Could not parse edge %d: %s\n", PROGRAM_NAME, i, argv[i]);
-        }
-        char *endptr = NULL;
-        buffer[i - 1][0] = strtol(numb, &endptr, 10);
-        if(buffer[i - 1][0] == LONG_MIN || buffer[i - 1][0] == LONG_MAX) {
-            if(errno == ERANGE) {
-                printStderrCleaupAndExit("[%s] ERROR: Converting long failed: %s\n", PROGRAM_NAME, strerror(errno));
-            }
-        }
-        if (endptr == optarg) {
-            printStderrCleaupAndExit("[%s] ERROR: No digits were found in the first node: %s\n", PROGRAM_NAME, errno);
+    char error[GRAPH_ERROR_SIZE];
+    if(graphFile != NULL) {
+        if(graphLoadFile(&graph, graphFile, error) == -1) {
+            printStderrCleaupAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, error);
         }
+        return NULL;
+    }
 
-        numb = strtok(NULL, "-");
-        if(numb == NULL) {
-            printStderrCleaupAndExit("[%s] ERROR: Could not parse edge %d: %s\n", PROGRAM_NAME, i, argv[i]);
-        }
-        endptr = NULL;
-        buffer[i - 1][1] = strtol(numb, &endptr, 10);
-        if(buffer[i - 1][1] == LONG_MIN || buffer[i - 1][1] == LONG_MAX) {
-            if(errno == ERANGE) {
-                printStderrCleaupAndExit("[%s] ERROR: Converting long failed: %s\n", PROGRAM_NAME, strerror(errno));
-            }
-        }
-        if (endptr == optarg) {
-            printStderrCleaupAndExit("[%s] ERROR: No digits were found in the first node: %s\n", PROGRAM_NAME, errno);
+    long (*edgeList)[2];
+    if((edgeList = malloc(sizeof(long[2]) * numEdges)) == NULL) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to allocate buffer: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    for(int i = 0; i < numEdges; ++i) {
+        if(graphParseEdgeArgument(argv[optind + i], edgeList[i]) == -1) {
+            free(edgeList);
+            fprintf(stderr, "[%s] ERROR: Could not parse edge %d: %s\n", PROGRAM_NAME, i + 1, argv[optind + i]);
+            printUsageAndExit();
         }
     }
-    
-    return buffer;
+
+    if(graphFromEdgeList(&graph, (const long (*)[2]) edgeList, numEdges, error) == -1) {
+        free(edgeList);
+        printStderrCleaupAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, error);
+    }
+    free(edgeList);
+    return NULL;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -166,7 +381,7 @@ static long** parseArguments(int argc, char **argv) {
  */
 static int closeSHM(void) {
     if(circularBufferData != NULL) {
-        if(munmap(circularBufferData, sizeof(circular_buffer_data_t)) == -1) {
+        if(munmap(circularBufferData, sharedMemorySize) == -1) {
             fprintf(stderr, "[%s] ERROR: Failed to unmap shared memory: %s\n", PROGRAM_NAME, strerror(errno));
             return -1;
         }
@@ -176,8 +391,9 @@ static int closeSHM(void) {
 
 /**
  * @brief Opens a shared memory space, maps it to an addressspace, closes the fileDescriptor and sets the global pointer to that address space.
+ *        The mapping covers the whole segment the supervisor created and is locked if the supervisor asked for it.
  *        If something fails it tires to close already open resources and outputs an error.
- * @details global variables: PROGRAM_NAME, circularBufferData
+ * @details global variables: PROGRAM_NAME, circularBufferData, sharedMemorySize
  */
 static void openSHM(void) {
     if(circularBufferData != NULL) {
@@ -189,15 +405,29 @@ static void openSHM(void) {
         printStderrCleaupAndExit("[%s] ERROR: Failed to open shared memory: %s\n", PROGRAM_NAME, strerror(errno));
     }
 
-    circularBufferData = mmap(NULL, sizeof(circular_buffer_data_t), PROT_READ | PROT_WRITE, MAP_SHARED, sharedMemoryFd, 0);
+    struct stat sharedMemoryStat;
+    if(fstat(sharedMemoryFd, &sharedMemoryStat) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to stat shared memory: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+    if(sharedMemoryStat.st_size < (off_t) sizeof(circular_buffer_data_t)) {
+        printStderrCleaupAndExit("[%s] ERROR: Shared memory is not initialised, is the supervisor running?\n", PROGRAM_NAME);
+    }
+    sharedMemorySize = sharedMemoryStat.st_size;
+
+    circularBufferData = mmap(NULL, sharedMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, sharedMemoryFd, 0);
 
     if(circularBufferData == MAP_FAILED) {
+        circularBufferData = NULL;
         printStderrCleaupAndExit("[%s] ERROR: Failed to map shared memory: %s\n", PROGRAM_NAME, strerror(errno));
     }
 
     if(close(sharedMemoryFd) == -1) {
         printStderrCleaupAndExit("[%s] ERROR: Failed to close shared memory file descriptor: %s\n", PROGRAM_NAME, strerror(errno));
     }
+
+    if(circularBufferData -> control.lockMemory && mlock(circularBufferData, sharedMemorySize) == -1) {
+        fprintf(stderr, "[%s] WARNING: Failed to lock shared memory: %s\n", PROGRAM_NAME, strerror(errno));
+    }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -253,6 +483,504 @@ static void openSEM(void) {
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Portfolio
+
+/**
+ * @brief Claims a worker slot in the shared memory so the supervisor can assign strategies to this generator.
+ *        If all slots are taken the generator runs with the first strategy.
+ * @details global variables: PROGRAM_NAME, circularBufferData, workerId
+ */
+static void registerWorker(void) {
+    int id = __atomic_fetch_add(&circularBufferData -> control.numWorkers, 1, __ATOMIC_ACQ_REL);
+    if(id >= MAX_NUM_WORKERS) {
+        fprintf(stderr, "[%s] WARNING: All %d worker slots are taken, running without strategy assignments\n", PROGRAM_NAME, MAX_NUM_WORKERS);
+        return;
+    }
+
+    workerId = id;
+    circularBufferData -> workers[id].pid = getpid();
+    __atomic_store_n(&circularBufferData -> workers[id].active, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Releases the worker slot of this generator
+ * @details global variables: circularBufferData, workerId
+ */
+static void unregisterWorker(void) {
+    if(circularBufferData != NULL && workerId != -1) {
+        __atomic_store_n(&circularBufferData -> workers[workerId].active, false, __ATOMIC_RELEASE);
+        workerId = -1;
+    }
+}
+
+/**
+ * @brief Reads the control word of this generator and reconfigures the kernel and random stream if the supervisor assigned a new strategy.
+ *        Remote generators keep the strategy they received when connecting.
+ * @details global variables: circularBufferData, workerId, currentStrategy, kernel, rng, baseSeed, remoteFd, remoteHello
+ */
+static void applyAssignedStrategy(void) {
+    int strategy = 0;
+    if(remoteFd != -1) {
+        strategy = remoteHello.strategy;
+    } else if(workerId != -1) {
+        strategy = __atomic_load_n(&circularBufferData -> workers[workerId].strategy, __ATOMIC_ACQUIRE);
+    }
+    if(strategy == currentStrategy || strategy < 0 || strategy >= NUM_STRATEGIES) {
+        return;
+    }
+
+    strategy_config_t config = remoteFd != -1 ? remoteHello.strategyConfig : circularBufferData -> strategies[strategy];
+    rngSeed(&rng, baseSeed + (uint64_t) config.seedStream * 0x9E3779B97F4A7C15ULL);
+    kernelSetStrategy(&kernel, config.restartInterval, config.samplingBias);
+    if(config.construction == CONSTRUCTION_DSATUR) {
+        kernelSetConstruction(&kernel, constructDsatur, &construct);
+    } else if(config.construction == CONSTRUCTION_RLF) {
+        kernelSetConstruction(&kernel, constructRlf, &construct);
+    } else {
+        kernelSetConstruction(&kernel, NULL, NULL);
+    }
+    currentStrategy = strategy;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Graph updates
+
+/**
+ * @brief Looks up a node of a delta and adds it to the graph and the kernel if it is new
+ * @details global variables: PROGRAM_NAME, graph, kernel, rng
+ * 
+ * @param id The node id
+ * @return The dense index of the node
+ */
+static uint32_t findOrAddNode(long id) {
+    long node = graphFindNode(&graph, id);
+    if(node != -1) {
+        return (uint32_t) node;
+    }
+    if((node = graphAddNode(&graph, id)) == -1 || kernelAddNode(&kernel, &rng) == -1) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to add node %ld: %s\n", PROGRAM_NAME, id, strerror(errno));
+    }
+    return (uint32_t) node;
+}
+
+/**
+ * @brief Applies one delta to the graph and the kernel. Adding an existing or removing a missing edge does nothing
+ * @details global variables: PROGRAM_NAME, graph, kernel
+ * 
+ * @param delta The delta
+ */
+static void applyDelta(const graph_delta_t *delta) {
+    if(delta -> operation == GRAPH_DELTA_REMOVE) {
+        long u = graphFindNode(&graph, delta -> nodes[0]);
+        long v = graphFindNode(&graph, delta -> nodes[1]);
+        long edge = u != -1 && v != -1 ? graphFindEdge(&graph, (uint32_t) u, (uint32_t) v) : -1;
+        if(edge != -1) {
+            graphRemoveEdge(&graph, edge);
+            kernelRemoveEdge(&kernel, edge);
+        }
+        return;
+    }
+
+    uint32_t u = findOrAddNode(delta -> nodes[0]);
+    uint32_t v = findOrAddNode(delta -> nodes[1]);
+    if(graphFindEdge(&graph, u, v) != -1) {
+        return;
+    }
+    if(graphAddEdge(&graph, u, v) == -1 || kernelAddEdge(&kernel, u, v) == -1) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to add edge [%ld, %ld]: %s\n", PROGRAM_NAME, delta -> nodes[0], delta -> nodes[1], strerror(errno));
+    }
+}
+
+/**
+ * @brief Builds the adjacency of graph and the repair, the construction buffers and the parallel tempering or the
+ *        independent set search on top of it, replacing the old ones. Their threads are stopped before the old
+ *        adjacency is freed. The kernel walks over the new adjacency. Graphs the independent set search cannot take are
+ *        searched with the kernel instead
+ * @details global variables: PROGRAM_NAME, graph, kernel, adjacency, repair, construct, numReplicas, tempering, baseSeed,
+ *          numIndependentThreads, independent, independentReported
+ */
+static void buildAdjacency(void) {
+    temperingFree(&tempering);
+    independentFree(&independent);
+    independentReported = false;
+    repairFree(&repair);
+    constructFree(&construct);
+    kernelSetAdjacency(&kernel, NULL);
+    graphFreeAdjacency(&adjacency);
+    if(graphBuildAdjacency(&adjacency, &graph) == -1 || repairCreate(&repair, &adjacency) == -1 ||
+        constructCreate(&construct, &adjacency, kernel.numColors) == -1 || kernelSetAdjacency(&kernel, &adjacency) == -1) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to build the adjacency of the graph: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    if(numReplicas > 0) {
+        if(temperingCreate(&tempering, &adjacency, kernel.numColors, numReplicas, baseSeed) == -1) {
+            freeAllocatedResources();
+            printStderrCleaupAndExit("[%s] ERROR: Failed to create %d tempering replicas: %s\n", PROGRAM_NAME, numReplicas, strerror(errno));
+        }
+        int result = temperingStart(&tempering);
+        if(result != 0) {
+            freeAllocatedResources();
+            printStderrCleaupAndExit("[%s] ERROR: Failed to start tempering threads: %s\n", PROGRAM_NAME, strerror(result));
+        }
+    }
+
+    if(numIndependentThreads == 0) {
+        return;
+    }
+    if(kernel.numColors != 3 || adjacency.numNodes > INDEPENDENT_MAX_NODES) {
+        fprintf(stderr, "[%s] WARNING: The independent set search needs 3 colors and at most %d nodes, searching with the kernel\n", PROGRAM_NAME, INDEPENDENT_MAX_NODES);
+        numIndependentThreads = 0;
+        return;
+    }
+    if(independentCreate(&independent, &adjacency, numIndependentThreads) == -1) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to create the independent set search: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+    int result = independentStart(&independent);
+    if(result != 0) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to start independent set threads: %s\n", PROGRAM_NAME, strerror(result));
+    }
+}
+
+/**
+ * @brief Applies all deltas the supervisor published since the last call. The coloring of the kernel is kept and
+ *        its conflicts are updated edge by edge, so the search continues from where it was on the changed graph
+ * @details global variables: PROGRAM_NAME, circularBufferData, graphVersion, kernel, edgeWeights, loadingEdgeWeights,
+ *          edgeWeightSequence
+ */
+static void applyGraphDeltas(void) {
+    graph_delta_log_t *log = &circularBufferData -> deltaLog;
+    uint64_t version = __atomic_load_n(&log -> version, __ATOMIC_ACQUIRE);
+    if(version == graphVersion) {
+        return;
+    }
+
+    // The weights and the adjacency are indexed by edge and are rebuilt for the changed graph
+    kernelSetAdjacency(&kernel, NULL);
+    kernelSetEdgeWeights(&kernel, NULL);
+    free(edgeWeights);
+    free(loadingEdgeWeights);
+    edgeWeights = NULL;
+    loadingEdgeWeights = NULL;
+    edgeWeightSequence = 0;
+
+    // Graphs that never change do not need the lookup tables, so they are built with the first update
+    if(graph.nodeTable == NULL && graphBuildIndex(&graph) == -1) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to index the graph for updates: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    for(; graphVersion < version; ++graphVersion) {
+        graph_delta_t delta = log -> deltas[graphVersion % MAX_NUM_GRAPH_DELTAS];
+        // The supervisor may have reused the slot while it was copied
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&log -> version, __ATOMIC_ACQUIRE) >= graphVersion + MAX_NUM_GRAPH_DELTAS) {
+            freeAllocatedResources();
+            printStderrCleaupAndExit("[%s] ERROR: Fell more than %d graph updates behind, restart the generator\n", PROGRAM_NAME, MAX_NUM_GRAPH_DELTAS);
+        }
+        applyDelta(&delta);
+    }
+
+    kernelSetFilter(&kernel, kernel.filter, graphVersion);
+    buildAdjacency();
+}
+
+/**
+ * @brief Copies the edge weights the supervisor published since the last call and lets the kernel walk minimise them.
+ *        The weights are copied into a second buffer, so the kernel never walks over a copy that overlapped a publication
+ * @details global variables: PROGRAM_NAME, circularBufferData, graph, kernel, edgeWeights, loadingEdgeWeights,
+ *          edgeWeightSequence
+ */
+static void applyEdgeWeights(void) {
+    if(loadingEdgeWeights == NULL && (loadingEdgeWeights = malloc(graph.numEdges > 0 ? graph.numEdges : 1)) == NULL) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to allocate edge weights: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+    if(weightsLoad(&circularBufferData -> edgeWeights, &graph, loadingEdgeWeights, &edgeWeightSequence)) {
+        uint8_t *loaded = loadingEdgeWeights;
+        loadingEdgeWeights = edgeWeights;
+        edgeWeights = loaded;
+        kernelSetEdgeWeights(&kernel, edgeWeights);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Remote
+
+/**
+ * @brief Connects to a supervisor over TCP and receives the graph, the number of colors and the strategy from it
+ * @details global variables: PROGRAM_NAME, remoteFd, remoteHello, graph
+ *
+ * @param address Address of the supervisor of the form {host}:{port}
+ */
+static void connectToSupervisor(const char *address) {
+    char error[TRANSPORT_ERROR_SIZE];
+    if((remoteFd = transportConnect(address, error)) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, error);
+    }
+    if(transportReceiveGraph(remoteFd, &remoteHello, &graph, error) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, error);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Results
+
+/**
+ * @brief Checks whether the generator should stop, either because of a signal or because the supervisor asked for it
+ * @details global variables: quitSignalRecieved, circularBufferData, remoteFd
+ */
+static bool stopRequested(void) {
+    if(quitSignalRecieved) {
+        return true;
+    }
+    if(remoteFd != -1) {
+        return transportStopRequested(remoteFd);
+    }
+    return circularBufferData -> control.stopGenerators;
+}
+
+/**
+ * @brief Writes a result into the next free slot of the circular buffer
+ * @details global variables: PROGRAM_NAME, semaphoreCollection, circularBufferData, workerId, currentStrategy
+ *
+ * @param edgesToRemove The edges to remove, unused entries are -1
+ * @param verdict One of the VERDICT_ values
+ */
+static void submitSharedMemory(const long edgesToRemove[MAX_NUM_EDGES_RESULT_SET][2], int verdict) {
+    traceEvent(TRACE_SEM_WAIT_BEGIN, TRACE_SEM_W_SYNC);
+    int waitResult = sem_wait(semaphoreCollection.wSyncSem);
+    traceEvent(TRACE_SEM_WAIT_END, TRACE_SEM_W_SYNC);
+    if(waitResult == -1) {
+        if(errno == EINTR) {
+            return;
+        }
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: There was an error waiting the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    traceEvent(TRACE_SEM_WAIT_BEGIN, TRACE_SEM_W);
+    waitResult = sem_wait(semaphoreCollection.wSem);
+    traceEvent(TRACE_SEM_WAIT_END, TRACE_SEM_W);
+    if(waitResult == -1) {
+        if(sem_post(semaphoreCollection.wSyncSem) == -1) {
+            freeAllocatedResources();
+            printStderrCleaupAndExit("[%s] ERROR: There was an error pushing the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+        }
+        if(errno == EINTR) {   
+            return;
+        }
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: There was an error waiting the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    for(int i = 0; i < MAX_NUM_EDGES_RESULT_SET; ++i) {
+        circularBufferData -> resultSets[circularBufferData -> writePos].edges[i][0] = edgesToRemove[i][0];
+        circularBufferData -> resultSets[circularBufferData -> writePos].edges[i][1] = edgesToRemove[i][1];
+    }
+    circularBufferData -> resultSets[circularBufferData -> writePos].worker = workerId;
+    circularBufferData -> resultSets[circularBufferData -> writePos].strategy = currentStrategy;
+    circularBufferData -> resultSets[circularBufferData -> writePos].verdict = verdict;
+    circularBufferData -> resultSets[circularBufferData -> writePos].graphVersion = graphVersion;
+    traceEvent(TRACE_SLOT_WRITE, circularBufferData -> writePos);
+
+    circularBufferData -> writePos = circularBufferData -> writePos + 1;
+    circularBufferData -> writePos = circularBufferData -> writePos % MAX_NUM_RESULT_SETS;
+
+    if(sem_post(semaphoreCollection.rSem) == -1) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: There was an error pushing the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    if(sem_post(semaphoreCollection.wSyncSem) == -1) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: There was an error pushing the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+}
+
+/**
+ * @brief Adds the evaluations the kernel skipped since the last call to the counter of the shared filter
+ * @details global variables: circularBufferData, kernel
+ */
+static void publishFilterSkips(void) {
+    if(kernel.filterSkips > 0) {
+        __atomic_fetch_add(&circularBufferData -> coloringFilter.skippedEvaluations, (uint64_t) kernel.filterSkips, __ATOMIC_RELAXED);
+        kernel.filterSkips = 0;
+    }
+}
+
+/**
+ * @brief Records the current coloring of the kernel in the shared filter
+ * @details global variables: circularBufferData, kernel
+ *
+ * @return true if some generator already reported the coloring or a permutation of its colors
+ */
+static bool isDuplicateResult(void) {
+    if(filterInsert(&circularBufferData -> coloringFilter, kernelColoringKey(&kernel))) {
+        return false;
+    }
+    __atomic_fetch_add(&circularBufferData -> coloringFilter.duplicateResults, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+/**
+ * @brief Passes a result to the supervisor, either through the shared memory or the TCP connection.
+ *        A remote supervisor cannot trust a result without edges, it gets the coloring of the kernel instead
+ * @details global variables: PROGRAM_NAME, remoteFd, currentStrategy, quitSignalRecieved, kernel
+ *
+ * @param edgesToRemove The edges to remove, unused entries are -1
+ * @param numEdges Number of used entries, 0 if the kernel holds a coloring without conflicts or the verdict is
+ *        VERDICT_UNCOLORABLE
+ * @param verdict One of the VERDICT_ values
+ */
+static void submitResult(const long edgesToRemove[MAX_NUM_EDGES_RESULT_SET][2], size_t numEdges, int verdict) {
+    if(remoteFd == -1) {
+        submitSharedMemory(edgesToRemove, verdict);
+        return;
+    }
+
+    int result;
+    if(numEdges == 0 && verdict != VERDICT_UNCOLORABLE) {
+        result = transportSendColoring(remoteFd, kernel.packedColors, kernel.numNodes, currentStrategy);
+    } else {
+        result = transportSendResult(remoteFd, edgesToRemove, numEdges, currentStrategy, verdict);
+    }
+    if(result == -1) {
+        if(errno != EPIPE && errno != ECONNRESET) {
+            fprintf(stderr, "[%s] ERROR: Failed to send result: %s\n", PROGRAM_NAME, strerror(errno));
+        }
+        // The supervisor is gone, nobody is waiting for results anymore
+        quitSignalRecieved = true;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Search
+
+/**
+ * @brief Runs one batch of the kernel search and repairs the coloring it finds
+ * @details global variables: kernel, rng, repair, graph, remoteFd
+ *
+ * @param conflicts Output buffer for the conflicting edges as node index pairs
+ * @return Number of conflicts of a new usable coloring, MAX_NUM_EDGES_RESULT_SET if there is none
+ */
+static size_t searchKernel(uint32_t conflicts[MAX_NUM_EDGES_RESULT_SET][2]) {
+    uint32_t conflictEdges[MAX_NUM_EDGES_RESULT_SET];
+    size_t numConflicts = kernel.search(&kernel, &rng, conflictEdges, MAX_NUM_EDGES_RESULT_SET, SEARCH_BATCH_ITERATIONS);
+    if(numConflicts >= MAX_NUM_EDGES_RESULT_SET) {
+        return MAX_NUM_EDGES_RESULT_SET;
+    }
+
+    // Try to swap the remaining conflicts away before reporting them
+    if(numConflicts > 0) {
+        numConflicts = repairColoring(&repair, &kernel, &graph, conflictEdges, numConflicts);
+        memcpy(conflictEdges, kernel.conflictSample, sizeof(uint32_t) * numConflicts);
+    }
+
+    // A coloring that was already reported would only fill the buffer with a result the supervisor has
+    if(remoteFd == -1 && numConflicts > 0 && isDuplicateResult()) {
+        return MAX_NUM_EDGES_RESULT_SET;
+    }
+
+    for(size_t i = 0; i < numConflicts; ++i) {
+        conflicts[i][0] = graph.edges[conflictEdges[i]][0];
+        conflicts[i][1] = graph.edges[conflictEdges[i]][1];
+    }
+    return numConflicts;
+}
+
+/**
+ * @brief Copies the coloring of the coldest tempering level into the kernel, which holds the colorings that are reported
+ * @details global variables: tempering, kernel
+ */
+static void takeTemperingColoring(void) {
+    const tempering_replica_t *replica = tempering.levels[0].replica;
+    for(size_t node = 0; node < kernel.numNodes; ++node) {
+        kernelSetColor(&kernel, node, replica -> colors[node]);
+    }
+    kernelAdoptColoring(&kernel);
+}
+
+/**
+ * @brief Reports the verdict of an exact solver as a result without edges. A coloring is only reported after the
+ *        kernel confirmed it
+ * @details global variables: adjacency, kernel
+ *
+ * @param verdict One of the VERDICT_ values, nothing is reported for VERDICT_UNKNOWN
+ * @param colors The color of every node if the verdict is VERDICT_COLORABLE
+ */
+static void reportVerdict(int verdict, const int8_t *colors) {
+    if(verdict == VERDICT_COLORABLE) {
+        for(size_t node = 0; node < adjacency.numNodes; ++node) {
+            kernelSetColor(&kernel, node, colors[node]);
+        }
+        kernelAdoptColoring(&kernel);
+        if(kernel.currentCost != 0) {
+            verdict = VERDICT_UNKNOWN;
+        }
+    }
+    if(verdict == VERDICT_UNKNOWN) {
+        return;
+    }
+
+    long edgesToRemove[MAX_NUM_EDGES_RESULT_SET][2];
+    for(int i = 0; i < MAX_NUM_EDGES_RESULT_SET; ++i) {
+        edgesToRemove[i][0] = -1;
+        edgesToRemove[i][1] = -1;
+    }
+    submitResult((const long (*)[2]) edgesToRemove, 0, verdict);
+}
+
+/**
+ * @brief Checks whether the graph belongs to a class that is colored exactly in linear time, or else has a tree
+ *        decomposition small enough for the dynamic programming, and reports the coloring or the proof that there is
+ *        none right away
+ * @details global variables: PROGRAM_NAME, adjacency, kernel
+ */
+static void solveByClassification(void) {
+    int8_t *colors = malloc(adjacency.numNodes > 0 ? adjacency.numNodes : 1);
+    classification_t classification;
+    if(colors == NULL || classifyGraph(&adjacency, kernel.numColors, colors, &classification) == -1) {
+        free(colors);
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to classify the graph: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    if(classification.verdict == VERDICT_UNKNOWN) {
+        long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+        int numThreads = numProcessors < 1 ? 1 : numProcessors > TREEDP_MAX_THREADS ? TREEDP_MAX_THREADS : (int) numProcessors;
+        size_t width;
+        if((classification.verdict = treeDpSolve(&adjacency, kernel.numColors, numThreads, colors, &width)) == -1) {
+            free(colors);
+            freeAllocatedResources();
+            printStderrCleaupAndExit("[%s] ERROR: Failed to solve the graph over its tree decomposition: %s\n", PROGRAM_NAME, strerror(errno));
+        }
+    }
+
+    reportVerdict(classification.verdict, colors);
+    free(colors);
+}
+
+/**
+ * @brief Reports the verdict of the independent set search once it is known, otherwise waits a moment for it
+ * @details global variables: independent, independentReported
+ */
+static void pollIndependentSets(void) {
+    int verdict = independentReported ? VERDICT_UNKNOWN : independentPoll(&independent);
+    if(verdict == VERDICT_UNKNOWN) {
+        struct timespec interval = {0, INDEPENDENT_POLL_INTERVAL_NS};
+        nanosleep(&interval, NULL);
+        return;
+    }
+    reportVerdict(verdict, independent.colors);
+    independentReported = true;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Singnal handler
 
@@ -289,6 +1017,18 @@ static void registerSignalHandler(void) {
 static void cleanup() {
     bool error = false;
 
+    unregisterWorker();
+
+    if(remoteFd != -1) {
+        close(remoteFd);
+        remoteFd = -1;
+    }
+
+    char traceError[TRACE_ERROR_SIZE];
+    if(traceClose(traceError) == -1) {
+        fprintf(stderr, "[%s] ERROR: %s\n", PROGRAM_NAME, traceError);
+        error = true;
+    }
     if(closeSHM() == -1) {
         error = true;
     }
@@ -302,31 +1042,22 @@ static void cleanup() {
 }
 
 /**
- * @brief Frees the two allocated memory spaces of edges and nodes
- * 
- * @param argc The argument count
- * @param edges A pointer to an allocated two dimensional array of the edges in the graph
- * @param nodesSize The size of the nodes array
- * @param nodes A pointer to an allocated two dimensional array of the nodes together with their color
- */
-static void freeAllocatedResources(int argc, long **edges, size_t nodesSize, long **nodes) {
-    if(edges != NULL) {
-        for(int x = 0; x < (argc - 1); ++x) {
-            free(edges[x]);
-            edges[x] = NULL;
-        } 
-        free(edges);
-        edges = NULL;
-    }
-
-    if(nodes != NULL) {
-        for(int x = 0; x < nodesSize; ++x) {
-            free(nodes[x]);
-            nodes[x] = NULL;
-        } 
-        free(nodes);
-        nodes = NULL;
-    }
+ * @brief Frees the graph, the kernel, the edge weights, the adjacency and everything built on it
+ * @details global variables: graph, kernel, edgeWeights, loadingEdgeWeights, adjacency, repair, construct, tempering,
+ *          independent
+ */
+static void freeAllocatedResources(void) {
+    temperingFree(&tempering);
+    independentFree(&independent);
+    free(edgeWeights);
+    free(loadingEdgeWeights);
+    edgeWeights = NULL;
+    loadingEdgeWeights = NULL;
+    graphFree(&graph);
+    kernelFree(&kernel);
+    repairFree(&repair);
+    constructFree(&construct);
+    graphFreeAdjacency(&adjacency);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -334,7 +1065,7 @@ static void freeAllocatedResources(int argc, long **edges, size_t nodesSize, lon
 
 /**
  * @brief Program entry point
- * @details global variables: PROGRAM_NAME, semaphoreCollection, circularBufferData, quitSignalRecieved
+ * @details global variables: PROGRAM_NAME, semaphoreCollection, circularBufferData, quitSignalRecieved, graph, kernel, repair, construct, rng, baseSeed, remoteHello
  * 
  * @param argc The argument counter
  * @param argv The argument vector
@@ -343,156 +1074,80 @@ static void freeAllocatedResources(int argc, long **edges, size_t nodesSize, lon
 int main(int argc, char **argv) {
     registerSignalHandler();
     PROGRAM_NAME = argv[0];
-    srand(time(NULL));
+    baseSeed = ((uint64_t) time(NULL) << 20) ^ (uint64_t) getpid();
+    rngSeed(&rng, baseSeed);
 
-    long **edges = parseArguments(argc, argv);
+    const char *remoteAddress = parseArguments(argc, argv);
 
-    openSHM();
-    openSEM();
+    int numColors;
+    if(remoteAddress != NULL) {
+        connectToSupervisor(remoteAddress);
+        numColors = remoteHello.numColors;
+    } else {
+        openSHM();
+        openSEM();
+        numColors = circularBufferData -> control.numColors;
+    }
 
-    // Initialise the nodes array to contain all nodes and colors
-    long** nodes;
-    size_t nodesSize = 16;
-    if((nodes = malloc(sizeof(long*) * nodesSize)) == NULL) {
-        freeAllocatedResources(argc, edges, nodesSize, nodes);
-        printStderrCleaupAndExit("[%s] ERROR: Failed to allocate buffer: %s\n", PROGRAM_NAME, strerror(errno));
+    // Pick the narrowest kernel for the graph and the number of colors the supervisor asks for
+    if(kernelCreate(&kernel, &graph, numColors) == -1) {
+        freeAllocatedResources();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to create kernel for %d colors: %s\n", PROGRAM_NAME, numColors, strerror(errno));
     }
-    for(int i = 0; i < nodesSize; ++i) {
-        nodes[i] = NULL;
-    }
-
-    // Extract all node into the nodes array
-    for(int i = 0; i < argc - 1; ++i) {
-        for(int a = 0; a < 2; ++a) {
-            int x;
-            for(x = 0; x < nodesSize; ++x) {
-                if(nodes[x] == NULL) {
-                    if((nodes[x] = malloc(sizeof(long) * 2)) == NULL) {
-                        freeAllocatedResources(argc, edges, nodesSize, nodes);
-                        printStderrCleaupAndExit("[%s] ERROR: Failed to allocate buffer: %s\n", PROGRAM_NAME, strerror(errno));
-                    }
-                    nodes[x][0] = edges[i][a];
-                    nodes[x][1] = 0;
-                    break;
-                } else if(nodes[x][0] == edges[i][a]) {
-                    break;
-                }
-            }
+    buildAdjacency();
 
-            if(x == nodesSize) {
-                nodesSize *= 2;
-                if((nodes = realloc(nodes, sizeof(long*) * nodesSize)) == NULL) {
-                    freeAllocatedResources(argc, edges, nodesSize, nodes);
-                    printStderrCleaupAndExit("[%s] ERROR: Failed to reallocate buffer: %s\n", PROGRAM_NAME, strerror(errno));
-                }
-                for(int y = nodesSize / 2; y < nodesSize; ++y) {
-                    nodes[y] = NULL;
-                }
-                if((nodes[nodesSize / 2] = malloc(sizeof(long) * 2)) == NULL) {
-                    freeAllocatedResources(argc, edges, nodesSize, nodes);
-                    printStderrCleaupAndExit("[%s] ERROR: Failed to allocate buffer: %s\n", PROGRAM_NAME, strerror(errno));
-                }
-                nodes[nodesSize / 2][0] = edges[i][a];
-                nodes[nodesSize / 2][1] = 0;
-            }
-        }
+    if(remoteAddress == NULL) {
+        registerWorker();
+        kernelSetFilter(&kernel, &circularBufferData -> coloringFilter, graphVersion);
     }
 
-    while(!quitSignalRecieved && !circularBufferData -> stopGenerators) {
-        // Generate a random coloring
-        for(int i = 0; i < nodesSize; ++i) {
-            if(nodes[i] != NULL) {
-                nodes[i][1] = (rand() % 3) + 1;
-            }
-        }
+    // Easy graphs are answered before the search starts, the search only runs until the supervisor stops it
+    solveByClassification();
 
-        // Generate a buffer in which to write the edges to remove
-        long edgesToRemove[MAX_NUM_EDGES_RESULT_SET][2];
-        for(int i = 0; i < MAX_NUM_EDGES_RESULT_SET; ++i) {
-            edgesToRemove[i][0] = -1;
-            edgesToRemove[i][1] = -1;
+    while(!stopRequested()) {
+        if(remoteFd == -1) {
+            applyGraphDeltas();
+            applyEdgeWeights();
+            publishFilterSkips();
         }
+        applyAssignedStrategy();
 
-        // Find out which edges to remove and add them to buffer
-        int edgeIndex = 0;
-        for(int i = 0; i < (argc - 1); ++i) {
-            int index1 = -1;
-            int index2 = -1;
-            for(int x = 0; x < nodesSize; ++x) {
-                if(nodes[x] == NULL) {
-                    break;
-                }
-                if(nodes[x][0] == edges[i][0]) {
-                    index1 = x;
-                }
-                if(nodes[x][0] == edges[i][1]) {
-                    index2 = x;
-                }
-                if(index1 != -1 && index2 != -1) {
-                    break;
-                }
-            }
-
-            if(index1 == -1 || index2 == -1) {
-                freeAllocatedResources(argc, edges, nodesSize, nodes);
-                printStderrCleaupAndExit("[%s] ERROR: There is an unmapped node!\n", PROGRAM_NAME);
-            }
-
-            if(nodes[index1][1] == nodes[index2][1]){
-                if(edgeIndex < MAX_NUM_EDGES_RESULT_SET) {
-                    edgesToRemove[edgeIndex][0] = edges[i][0];
-                    edgesToRemove[edgeIndex][1] = edges[i][1];
-                    ++edgeIndex;
-                }
-            }
+        // The independent set search runs on its own threads and only has a verdict to report
+        if(numIndependentThreads > 0) {
+            pollIndependentSets();
+            continue;
         }
 
+        // Search until a coloring is small enough to be a result
+        uint32_t conflicts[MAX_NUM_EDGES_RESULT_SET][2];
+        traceEvent(TRACE_EVALUATE_BEGIN, 0);
+        size_t numConflicts = numReplicas > 0 ? temperingRun(&tempering, TEMPERING_BATCH_MOVES, conflicts, MAX_NUM_EDGES_RESULT_SET) : searchKernel(conflicts);
+        traceEvent(TRACE_EVALUATE_END, (int32_t) numConflicts);
+
         // Continue searching since the result is too large
-        if(edgeIndex >= MAX_NUM_EDGES_RESULT_SET) {
+        if(numConflicts >= MAX_NUM_EDGES_RESULT_SET) {
             continue;
         }
-        
-        if(sem_wait(semaphoreCollection.wSyncSem) == -1) {
-            if(errno == EINTR) {
-                continue;
-            }
-            freeAllocatedResources(argc, edges, nodesSize, nodes);
-            printStderrCleaupAndExit("[%s] ERROR: There was an error waiting the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
-        }
-
-        if(sem_wait(semaphoreCollection.wSem) == -1) {
-            if(sem_post(semaphoreCollection.wSyncSem) == -1) {
-                freeAllocatedResources(argc, edges, nodesSize, nodes);
-                printStderrCleaupAndExit("[%s] ERROR: There was an error pushing the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
-            }
-            if(errno == EINTR) {   
-                continue;
-            }
-            freeAllocatedResources(argc, edges, nodesSize, nodes);
-            printStderrCleaupAndExit("[%s] ERROR: There was an error waiting the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+        if(numConflicts == 0 && numReplicas > 0) {
+            takeTemperingColoring();
         }
 
+        // Generate a buffer in which to write the edges to remove
+        long edgesToRemove[MAX_NUM_EDGES_RESULT_SET][2];
         for(int i = 0; i < MAX_NUM_EDGES_RESULT_SET; ++i) {
-            circularBufferData -> resultSets[circularBufferData -> writePos][i][0] = edgesToRemove[i][0];
-            circularBufferData -> resultSets[circularBufferData -> writePos][i][1] = edgesToRemove[i][1];
+            edgesToRemove[i][0] = -1;
+            edgesToRemove[i][1] = -1;
         }
-
-        circularBufferData -> writePos = circularBufferData -> writePos + 1;
-        circularBufferData -> writePos = circularBufferData -> writePos % MAX_NUM_RESULT_SETS;
-
-        if(sem_post(semaphoreCollection.rSem) == -1) {
-            freeAllocatedResources(argc, edges, nodesSize, nodes);
-            printStderrCleaupAndExit("[%s] ERROR: There was an error pushing the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+        for(size_t i = 0; i < numConflicts; ++i) {
+            edgesToRemove[i][0] = graph.nodeIds[conflicts[i][0]];
+            edgesToRemove[i][1] = graph.nodeIds[conflicts[i][1]];
         }
 
-        if(sem_post(semaphoreCollection.wSyncSem) == -1) {
-            freeAllocatedResources(argc, edges, nodesSize, nodes);
-            printStderrCleaupAndExit("[%s] ERROR: There was an error pushing the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
-        }
+        submitResult((const long (*)[2]) edgesToRemove, numConflicts, numConflicts == 0 ? VERDICT_COLORABLE : VERDICT_UNKNOWN);
     }
 
-    freeAllocatedResources(argc, edges, nodesSize, nodes);
+    freeAllocatedResources();
     cleanup();
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,872 @@
+/**
+ * @file graph.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Construction of the dense graph representation shared by all search kernels
+ * @details Graph files are mapped into memory and scanned with a hand written integer scanner.
+ *          Node ids and edges are normalised with radix sorts so that large files load in linear time.
+ *
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+
+/**
+ * @brief Node ids are relabeled with a bitmap over their range instead of a sort if the range is at most
+ *        this factor larger than the number of node ids in the edge list
+ */
+#define DIRECT_RELABEL_FACTOR 8
+
+/**
+ * @brief Number of bits the radix sort handles per pass. 2048 buckets keep the histogram in the L1 cache
+ */
+#define RADIX_BITS 11
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+/**
+ * @brief Maximum number of node ranges the edges are scattered into before they are sorted range by range
+ */
+#define EDGE_BUCKETS 2048
+
+/**
+ * @brief Initial number of edges the file parser allocates space for
+ */
+#define INITIAL_EDGE_CAPACITY 1024
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Sorting
+
+/**
+ * @brief Returns the number of significant bits of value
+ */
+static int bitWidth(uint64_t value) {
+    int width = 0;
+    while(value != 0) {
+        ++width;
+        value >>= 1;
+    }
+    return width;
+}
+
+/**
+ * @brief Sorts keys with an LSD radix sort over RADIX_BITS bit digits. Only the digits below maxKey are sorted
+ *        and passes in which every key has the same digit are skipped.
+ *
+ * @param keys The keys to sort
+ * @param scratch Buffer of the same size as keys
+ * @param count Number of keys
+ * @param maxKey Largest key
+ * @return Either keys or scratch, whichever holds the sorted keys. NULL if the histograms cannot be allocated
+ */
+static uint64_t* radixSort(uint64_t *keys, uint64_t *scratch, size_t count, uint64_t maxKey) {
+    int passes = (bitWidth(maxKey) + RADIX_BITS - 1) / RADIX_BITS;
+    size_t *histograms = calloc((size_t) (passes > 0 ? passes : 1) * RADIX_BUCKETS, sizeof(size_t));
+    if(histograms == NULL) {
+        return NULL;
+    }
+
+    for(size_t i = 0; i < count; ++i) {
+        for(int pass = 0; pass < passes; ++pass) {
+            ++histograms[pass * RADIX_BUCKETS + ((keys[i] >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1))];
+        }
+    }
+
+    for(int pass = 0; pass < passes; ++pass) {
+        size_t *histogram = histograms + pass * RADIX_BUCKETS;
+        int shift = pass * RADIX_BITS;
+        if(count == 0 || histogram[(keys[0] >> shift) & (RADIX_BUCKETS - 1)] == count) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for(size_t digit = 0; digit < RADIX_BUCKETS; ++digit) {
+            size_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+        for(size_t i = 0; i < count; ++i) {
+            scratch[histogram[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++] = keys[i];
+        }
+
+        uint64_t *swap = keys;
+        keys = scratch;
+        scratch = swap;
+    }
+
+    free(histograms);
+    return keys;
+}
+
+/**
+ * @brief Maps a signed node id to an unsigned key with the same order
+ */
+static uint64_t nodeIdKey(long nodeId) {
+    return (uint64_t) nodeId ^ (UINT64_C(1) << 63);
+}
+
+/**
+ * @brief Finds the dense index of a node id in the sorted node id array
+ *
+ * @param nodeIds Sorted unique node ids
+ * @param numNodes Length of nodeIds
+ * @param nodeId The node id to look up
+ * @return The index of nodeId
+ */
+static uint32_t findNodeIndex(const long *nodeIds, size_t numNodes, long nodeId) {
+    size_t low = 0;
+    size_t high = numNodes;
+    while(low < high) {
+        size_t middle = low + (high - low) / 2;
+        if(nodeIds[middle] < nodeId) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return (uint32_t) low;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Relabeling
+
+/**
+ * @brief Node id lookup structure. Either a bitmap with rank prefix over the id range or a sorted id array.
+ *
+ */
+typedef struct {
+    long minId;
+    uint64_t *bitmap;
+    uint32_t *rank;
+} relabel_table_t;
+
+/**
+ * @brief Counts the set bits of a word without relying on a popcount instruction being available
+ */
+static inline uint32_t countBits(uint64_t word) {
+    word = word - ((word >> 1) & UINT64_C(0x5555555555555555));
+    word = (word & UINT64_C(0x3333333333333333)) + ((word >> 2) & UINT64_C(0x3333333333333333));
+    word = (word + (word >> 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+    return (uint32_t) ((word * UINT64_C(0x0101010101010101)) >> 56);
+}
+
+/**
+ * @brief Looks up the dense index of a node id
+ */
+static inline uint32_t relabelNode(const relabel_table_t *table, const graph_t *graph, long nodeId) {
+    if(table -> bitmap == NULL) {
+        return findNodeIndex(graph -> nodeIds, graph -> numNodes, nodeId);
+    }
+    uint64_t offset = (uint64_t) nodeId - (uint64_t) table -> minId;
+    uint64_t below = table -> bitmap[offset >> 6] & ((UINT64_C(1) << (offset & 63)) - 1);
+    return table -> rank[offset >> 6] + countBits(below);
+}
+
+/**
+ * @brief Marks all node ids in a bitmap over their range and stores the rank of every bitmap word.
+ *        The bitmap and rank arrays are small enough to stay in cache, so relabeling costs one popcount per node id.
+ *
+ * @param table The table to fill
+ * @param graph The graph to fill with nodeIds
+ * @param edgeList The edges as pairs of node ids
+ * @param numEdges The number of edges
+ * @param minId Smallest node id
+ * @param range Number of ids between the smallest and the largest node id
+ * @return 0 on success, -1 on failure
+ */
+static int relabelWithBitmap(relabel_table_t *table, graph_t *graph, const long (*edgeList)[2], size_t numEdges, long minId, uint64_t range) {
+    size_t words = (range + 63) / 64;
+    table -> minId = minId;
+    if((table -> bitmap = calloc(words, sizeof(uint64_t))) == NULL || (table -> rank = malloc(words * sizeof(uint32_t))) == NULL) {
+        return -1;
+    }
+
+    for(size_t i = 0; i < numEdges; ++i) {
+        for(int a = 0; a < 2; ++a) {
+            uint64_t offset = (uint64_t) edgeList[i][a] - (uint64_t) minId;
+            table -> bitmap[offset >> 6] |= UINT64_C(1) << (offset & 63);
+        }
+    }
+
+    size_t numNodes = 0;
+    for(size_t word = 0; word < words; ++word) {
+        table -> rank[word] = (uint32_t) numNodes;
+        numNodes += countBits(table -> bitmap[word]);
+    }
+    if(numNodes >= UINT32_MAX || (graph -> nodeIds = malloc(sizeof(long) * numNodes)) == NULL) {
+        return -1;
+    }
+    graph -> numNodes = numNodes;
+
+    for(size_t word = 0, node = 0; word < words; ++word) {
+        for(uint64_t bits = table -> bitmap[word]; bits != 0; bits &= bits - 1) {
+            graph -> nodeIds[node++] = minId + (long) (word * 64 + __builtin_ctzll(bits));
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Collects the node ids by sorting them. They are looked up with a binary search afterwards.
+ *
+ * @param graph The graph to fill with nodeIds
+ * @param edgeList The edges as pairs of node ids
+ * @param numEdges The number of edges
+ * @return 0 on success, -1 on failure
+ */
+static int relabelWithSort(graph_t *graph, const long (*edgeList)[2], size_t numEdges) {
+    uint64_t *keys = malloc(sizeof(uint64_t) * 2 * numEdges);
+    uint64_t *scratch = malloc(sizeof(uint64_t) * 2 * numEdges);
+    if(keys == NULL || scratch == NULL) {
+        free(keys);
+        free(scratch);
+        return -1;
+    }
+
+    uint64_t maxKey = 0;
+    for(size_t i = 0; i < numEdges; ++i) {
+        keys[2 * i] = nodeIdKey(edgeList[i][0]);
+        keys[2 * i + 1] = nodeIdKey(edgeList[i][1]);
+        maxKey = keys[2 * i] > maxKey ? keys[2 * i] : maxKey;
+        maxKey = keys[2 * i + 1] > maxKey ? keys[2 * i + 1] : maxKey;
+    }
+
+    uint64_t *sorted = radixSort(keys, scratch, 2 * numEdges, maxKey);
+    if(sorted == NULL) {
+        free(keys);
+        free(scratch);
+        return -1;
+    }
+
+    size_t numNodes = 0;
+    for(size_t i = 0; i < 2 * numEdges; ++i) {
+        if(i == 0 || sorted[i] != sorted[i - 1]) {
+            // Reuse the sorted buffer for the unique ids, they never overtake the read position
+            ((long*) sorted)[numNodes++] = (long) (sorted[i] ^ (UINT64_C(1) << 63));
+        }
+    }
+
+    if(numNodes >= UINT32_MAX || (graph -> nodeIds = malloc(sizeof(long) * numNodes)) == NULL) {
+        free(keys);
+        free(scratch);
+        return -1;
+    }
+    memcpy(graph -> nodeIds, sorted, sizeof(long) * numNodes);
+    graph -> numNodes = numNodes;
+
+    free(keys);
+    free(scratch);
+    return 0;
+}
+
+/**
+ * @brief Normalises the edges in linear time. One streaming pass scatters every edge into one of at most EDGE_BUCKETS
+ *        ranges of its smaller endpoint, then each range is small enough to be counting sorted by that endpoint
+ *        and deduplicated with a last-seen array while it stays in cache.
+ *
+ * @param graph The graph to fill with edges
+ * @param table The node id lookup structure
+ * @param edgeList The edges as pairs of node ids
+ * @param numEdges The number of edges
+ * @return 0 on success, -1 on failure
+ */
+static int buildUniqueEdges(graph_t *graph, const relabel_table_t *table, const long (*edgeList)[2], size_t numEdges) {
+    size_t numNodes = graph -> numNodes;
+    int shift = 0;
+    while((numNodes >> shift) >= EDGE_BUCKETS) {
+        ++shift;
+    }
+    size_t numBuckets = (numNodes >> shift) + 1;
+    size_t bucketNodes = (size_t) 1 << shift;
+
+    uint64_t *keys = malloc(sizeof(uint64_t) * numEdges);
+    uint64_t *scratch = malloc(sizeof(uint64_t) * numEdges);
+    size_t *bucketStart = calloc(numBuckets + 1, sizeof(size_t));
+    size_t *cursor = malloc(sizeof(size_t) * (numBuckets > bucketNodes ? numBuckets : bucketNodes));
+    uint32_t *lastSeen = calloc(numNodes, sizeof(uint32_t));
+    if(keys == NULL || scratch == NULL || bucketStart == NULL || cursor == NULL || lastSeen == NULL) {
+        free(keys);
+        free(scratch);
+        free(bucketStart);
+        free(cursor);
+        free(lastSeen);
+        return -1;
+    }
+
+    for(size_t i = 0; i < numEdges; ++i) {
+        uint64_t u = relabelNode(table, graph, edgeList[i][0]);
+        uint64_t v = relabelNode(table, graph, edgeList[i][1]);
+        keys[i] = u < v ? (u << 32) | v : (v << 32) | u;
+        ++bucketStart[((u < v ? u : v) >> shift) + 1];
+    }
+    for(size_t bucket = 0; bucket < numBuckets; ++bucket) {
+        bucketStart[bucket + 1] += bucketStart[bucket];
+        cursor[bucket] = bucketStart[bucket];
+    }
+    for(size_t i = 0; i < numEdges; ++i) {
+        scratch[cursor[(keys[i] >> 32) >> shift]++] = keys[i];
+    }
+
+    size_t uniqueEdges = 0;
+    for(size_t bucket = 0; bucket < numBuckets; ++bucket) {
+        size_t begin = bucketStart[bucket];
+        size_t end = bucketStart[bucket + 1];
+        size_t firstNode = bucket << shift;
+
+        // Counting sort of the bucket by its smaller endpoint back into keys
+        memset(cursor, 0, sizeof(size_t) * bucketNodes);
+        for(size_t i = begin; i < end; ++i) {
+            ++cursor[(scratch[i] >> 32) - firstNode];
+        }
+        for(size_t node = 0, offset = begin; node < bucketNodes; ++node) {
+            size_t count = cursor[node];
+            cursor[node] = offset;
+            offset += count;
+        }
+        for(size_t i = begin; i < end; ++i) {
+            keys[cursor[(scratch[i] >> 32) - firstNode]++] = scratch[i];
+        }
+
+        // The unique edges are compacted to the front, they never overtake the read position
+        for(size_t i = begin; i < end; ++i) {
+            uint32_t u = (uint32_t) (keys[i] >> 32);
+            uint32_t v = (uint32_t) keys[i];
+            if(lastSeen[v] != u + 1) {
+                lastSeen[v] = u + 1;
+                keys[uniqueEdges++] = keys[i];
+            }
+        }
+    }
+    free(scratch);
+    free(bucketStart);
+    free(cursor);
+    free(lastSeen);
+
+    if((graph -> edges = malloc(sizeof(uint32_t[2]) * uniqueEdges)) == NULL) {
+        free(keys);
+        return -1;
+    }
+    for(size_t i = 0; i < uniqueEdges; ++i) {
+        graph -> edges[i][0] = (uint32_t) (keys[i] >> 32);
+        graph -> edges[i][1] = (uint32_t) keys[i];
+    }
+    graph -> numEdges = uniqueEdges;
+
+    free(keys);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Construction
+
+int graphFromEdgeList(graph_t *graph, const long (*edgeList)[2], size_t numEdges, char *error) {
+    memset(graph, 0, sizeof(*graph));
+
+    if(numEdges == 0) {
+        snprintf(error, GRAPH_ERROR_SIZE, "The graph has no edges");
+        return -1;
+    }
+
+    long minId = LONG_MAX;
+    long maxId = LONG_MIN;
+    for(size_t i = 0; i < numEdges; ++i) {
+        // A node adjacent to itself can never be colored properly, the search would never terminate
+        if(edgeList[i][0] == edgeList[i][1]) {
+            snprintf(error, GRAPH_ERROR_SIZE, "Self-loop on node %ld makes the graph uncolorable", edgeList[i][0]);
+            return -1;
+        }
+        for(int a = 0; a < 2; ++a) {
+            minId = edgeList[i][a] < minId ? edgeList[i][a] : minId;
+            maxId = edgeList[i][a] > maxId ? edgeList[i][a] : maxId;
+        }
+    }
+
+    errno = 0;
+    relabel_table_t table = {
+        0,
+        NULL,
+        NULL,
+    };
+    uint64_t range = (uint64_t) maxId - (uint64_t) minId + 1;
+    int result;
+    if(range != 0 && range / DIRECT_RELABEL_FACTOR <= 2 * numEdges) {
+        result = relabelWithBitmap(&table, graph, edgeList, numEdges, minId, range);
+    } else {
+        result = relabelWithSort(graph, edgeList, numEdges);
+    }
+    if(result == -1) {
+        snprintf(error, GRAPH_ERROR_SIZE, "Failed to relabel nodes: %s", errno == 0 ? "too many nodes" : strerror(errno));
+        free(table.bitmap);
+        free(table.rank);
+        graphFree(graph);
+        return -1;
+    }
+
+    result = buildUniqueEdges(graph, &table, edgeList, numEdges);
+    free(table.bitmap);
+    free(table.rank);
+    if(result == -1) {
+        snprintf(error, GRAPH_ERROR_SIZE, "Failed to sort edges: %s", strerror(errno));
+        graphFree(graph);
+        return -1;
+    }
+
+    graph -> nodeCapacity = graph -> numNodes;
+    graph -> edgeCapacity = graph -> numEdges;
+    return 0;
+}
+
+void graphFree(graph_t *graph) {
+    free(graph -> nodeIds);
+    free(graph -> edges);
+    free(graph -> nodeTable);
+    free(graph -> edgeTable);
+    memset(graph, 0, sizeof(*graph));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Updates
+
+/**
+ * @brief The splitmix64 finalizer, spreads node ids and edges over the slots of the index tables
+ */
+static inline uint64_t mixKey(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Home slot of an edge in the edge table
+ */
+static inline size_t edgeHome(const graph_t *graph, uint32_t first, uint32_t second) {
+    return (size_t) mixKey(((uint64_t) first << 32) | second) & graph -> edgeTableMask;
+}
+
+/**
+ * @brief Finds the slot of a node id, either the slot holding it or the empty slot it belongs into
+ */
+static size_t findNodeSlot(const graph_t *graph, long id) {
+    size_t slot = (size_t) mixKey((uint64_t) id) & graph -> nodeTableMask;
+    while(graph -> nodeTable[slot] != 0 && graph -> nodeIds[graph -> nodeTable[slot] - 1] != id) {
+        slot = (slot + 1) & graph -> nodeTableMask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Finds the slot of an edge, either the slot holding it or the empty slot it belongs into
+ */
+static size_t findEdgeSlot(const graph_t *graph, uint32_t first, uint32_t second) {
+    size_t slot = edgeHome(graph, first, second);
+    while(graph -> edgeTable[slot] != 0) {
+        const uint32_t *edge = graph -> edges[graph -> edgeTable[slot] - 1];
+        if(edge[0] == first && edge[1] == second) {
+            break;
+        }
+        slot = (slot + 1) & graph -> edgeTableMask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Returns the power of two table size that keeps the load of a table with count entries at most one half
+ */
+static size_t tableSize(size_t count) {
+    size_t size = 16;
+    while(size < 2 * count) {
+        size *= 2;
+    }
+    return size;
+}
+
+/**
+ * @brief Rebuilds the node table with room for numEntries nodes
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int rebuildNodeTable(graph_t *graph, size_t numEntries) {
+    size_t size = tableSize(numEntries);
+    uint32_t *table = calloc(size, sizeof(uint32_t));
+    if(table == NULL) {
+        return -1;
+    }
+    free(graph -> nodeTable);
+    graph -> nodeTable = table;
+    graph -> nodeTableMask = size - 1;
+    for(size_t node = 0; node < graph -> numNodes; ++node) {
+        graph -> nodeTable[findNodeSlot(graph, graph -> nodeIds[node])] = (uint32_t) node + 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Rebuilds the edge table with room for numEntries edges
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int rebuildEdgeTable(graph_t *graph, size_t numEntries) {
+    size_t size = tableSize(numEntries);
+    uint32_t *table = calloc(size, sizeof(uint32_t));
+    if(table == NULL) {
+        return -1;
+    }
+    free(graph -> edgeTable);
+    graph -> edgeTable = table;
+    graph -> edgeTableMask = size - 1;
+    for(size_t i = 0; i < graph -> numEdges; ++i) {
+        graph -> edgeTable[findEdgeSlot(graph, graph -> edges[i][0], graph -> edges[i][1])] = (uint32_t) i + 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Empties a slot of the edge table. The entries behind it are shifted back into the hole wherever their
+ *        probe sequence passes it, so lookups never need tombstones
+ */
+static void clearEdgeSlot(graph_t *graph, size_t slot) {
+    size_t mask = graph -> edgeTableMask;
+    for(size_t next = (slot + 1) & mask; graph -> edgeTable[next] != 0; next = (next + 1) & mask) {
+        const uint32_t *edge = graph -> edges[graph -> edgeTable[next] - 1];
+        size_t home = edgeHome(graph, edge[0], edge[1]);
+        if(((next - home) & mask) >= ((next - slot) & mask)) {
+            graph -> edgeTable[slot] = graph -> edgeTable[next];
+            slot = next;
+        }
+    }
+    graph -> edgeTable[slot] = 0;
+}
+
+int graphBuildIndex(graph_t *graph) {
+    if(graph -> numEdges >= UINT32_MAX) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if(rebuildNodeTable(graph, graph -> numNodes) == -1 || rebuildEdgeTable(graph, graph -> numEdges) == -1) {
+        return -1;
+    }
+    return 0;
+}
+
+long graphFindNode(const graph_t *graph, long id) {
+    uint32_t entry = graph -> nodeTable[findNodeSlot(graph, id)];
+    return entry != 0 ? (long) entry - 1 : -1;
+}
+
+long graphAddNode(graph_t *graph, long id) {
+    if(graph -> numNodes == UINT32_MAX - 1) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if(graph -> numNodes == graph -> nodeCapacity) {
+        size_t capacity = graph -> nodeCapacity > 0 ? graph -> nodeCapacity * 2 : 16;
+        long *nodeIds = realloc(graph -> nodeIds, sizeof(long) * capacity);
+        if(nodeIds == NULL) {
+            return -1;
+        }
+        graph -> nodeIds = nodeIds;
+        graph -> nodeCapacity = capacity;
+    }
+    if(2 * (graph -> numNodes + 1) > graph -> nodeTableMask + 1 && rebuildNodeTable(graph, graph -> numNodes + 1) == -1) {
+        return -1;
+    }
+
+    graph -> nodeIds[graph -> numNodes] = id;
+    graph -> nodeTable[findNodeSlot(graph, id)] = (uint32_t) graph -> numNodes + 1;
+    return (long) graph -> numNodes++;
+}
+
+long graphFindEdge(const graph_t *graph, uint32_t u, uint32_t v) {
+    uint32_t entry = graph -> edgeTable[findEdgeSlot(graph, u < v ? u : v, u < v ? v : u)];
+    return entry != 0 ? (long) entry - 1 : -1;
+}
+
+int graphAddEdge(graph_t *graph, uint32_t u, uint32_t v) {
+    if(graph -> numEdges == UINT32_MAX - 1) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if(graph -> numEdges == graph -> edgeCapacity) {
+        size_t capacity = graph -> edgeCapacity > 0 ? graph -> edgeCapacity * 2 : 16;
+        uint32_t (*edges)[2] = realloc(graph -> edges, sizeof(uint32_t[2]) * capacity);
+        if(edges == NULL) {
+            return -1;
+        }
+        graph -> edges = edges;
+        graph -> edgeCapacity = capacity;
+    }
+    if(2 * (graph -> numEdges + 1) > graph -> edgeTableMask + 1 && rebuildEdgeTable(graph, graph -> numEdges + 1) == -1) {
+        return -1;
+    }
+
+    uint32_t first = u < v ? u : v;
+    uint32_t second = u < v ? v : u;
+    graph -> edges[graph -> numEdges][0] = first;
+    graph -> edges[graph -> numEdges][1] = second;
+    graph -> edgeTable[findEdgeSlot(graph, first, second)] = (uint32_t) graph -> numEdges + 1;
+    ++graph -> numEdges;
+    return 0;
+}
+
+void graphRemoveEdge(graph_t *graph, size_t edge) {
+    clearEdgeSlot(graph, findEdgeSlot(graph, graph -> edges[edge][0], graph -> edges[edge][1]));
+
+    size_t last = graph -> numEdges - 1;
+    if(edge != last) {
+        graph -> edgeTable[findEdgeSlot(graph, graph -> edges[last][0], graph -> edges[last][1])] = (uint32_t) edge + 1;
+        graph -> edges[edge][0] = graph -> edges[last][0];
+        graph -> edges[edge][1] = graph -> edges[last][1];
+    }
+    graph -> numEdges = last;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Adjacency
+
+int graphBuildAdjacency(graph_adjacency_t *adjacency, const graph_t *graph) {
+    memset(adjacency, 0, sizeof(*adjacency));
+    if(2 * graph -> numEdges > UINT32_MAX) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+
+    adjacency -> numNodes = graph -> numNodes;
+    adjacency -> offsets = calloc(graph -> numNodes + 1, sizeof(uint32_t));
+    adjacency -> neighbors = malloc(sizeof(uint32_t) * (graph -> numEdges > 0 ? 2 * graph -> numEdges : 1));
+    adjacency -> edgeIds = malloc(sizeof(uint32_t) * (graph -> numEdges > 0 ? 2 * graph -> numEdges : 1));
+    if(adjacency -> offsets == NULL || adjacency -> neighbors == NULL || adjacency -> edgeIds == NULL) {
+        graphFreeAdjacency(adjacency);
+        return -1;
+    }
+
+    // Count the degrees, turn them into start offsets and fill every row from its start
+    for(size_t i = 0; i < graph -> numEdges; ++i) {
+        ++adjacency -> offsets[graph -> edges[i][0] + 1];
+        ++adjacency -> offsets[graph -> edges[i][1] + 1];
+    }
+    for(size_t node = 0; node < graph -> numNodes; ++node) {
+        adjacency -> offsets[node + 1] += adjacency -> offsets[node];
+    }
+    for(size_t i = 0; i < graph -> numEdges; ++i) {
+        uint32_t u = graph -> edges[i][0];
+        uint32_t v = graph -> edges[i][1];
+        adjacency -> edgeIds[adjacency -> offsets[u]] = (uint32_t) i;
+        adjacency -> neighbors[adjacency -> offsets[u]++] = v;
+        adjacency -> edgeIds[adjacency -> offsets[v]] = (uint32_t) i;
+        adjacency -> neighbors[adjacency -> offsets[v]++] = u;
+    }
+    // Filling moved every offset to the start of the next row
+    for(size_t node = graph -> numNodes; node > 0; --node) {
+        adjacency -> offsets[node] = adjacency -> offsets[node - 1];
+    }
+    adjacency -> offsets[0] = 0;
+
+    return 0;
+}
+
+void graphFreeAdjacency(graph_adjacency_t *adjacency) {
+    free(adjacency -> offsets);
+    free(adjacency -> neighbors);
+    free(adjacency -> edgeIds);
+    memset(adjacency, 0, sizeof(*adjacency));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Parsing
+
+/**
+ * @brief Skips spaces, tabs and carriage returns
+ *
+ * @param position Current position
+ * @param end End of the input
+ * @return The first position that is not blank
+ */
+static inline const char* skipBlanks(const char *position, const char *end) {
+    while(position < end && (*position == ' ' || *position == '\t' || *position == '\r')) {
+        ++position;
+    }
+    return position;
+}
+
+/**
+ * @brief Scans a non negative decimal node id
+ *
+ * @param position Current position
+ * @param end End of the input
+ * @param nodeId Output for the scanned id
+ * @return The position after the id or NULL if there are no digits or the id overflows a long
+ */
+static inline const char* scanNodeId(const char *position, const char *end, long *nodeId) {
+    if(position == end || (unsigned) (*position - '0') > 9) {
+        return NULL;
+    }
+
+    unsigned long value = 0;
+    do {
+        unsigned digit = (unsigned) (*position - '0');
+        if(value > ((unsigned long) LONG_MAX - digit) / 10) {
+            return NULL;
+        }
+        value = value * 10 + digit;
+        ++position;
+    } while(position < end && (unsigned) (*position - '0') <= 9);
+
+    *nodeId = (long) value;
+    return position;
+}
+
+/**
+ * @brief Scans an edge of two node ids separated by blanks, a dash or a comma
+ *
+ * @param position Current position
+ * @param end End of the input
+ * @param edge Output for the two node ids
+ * @return The position after the edge and trailing blanks or NULL if there is no valid edge
+ */
+static inline const char* scanEdge(const char *position, const char *end, long edge[2]) {
+    if((position = scanNodeId(position, end, &edge[0])) == NULL) {
+        return NULL;
+    }
+    position = skipBlanks(position, end);
+    if(position < end && (*position == '-' || *position == ',')) {
+        position = skipBlanks(position + 1, end);
+    }
+    if((position = scanNodeId(position, end, &edge[1])) == NULL) {
+        return NULL;
+    }
+    return skipBlanks(position, end);
+}
+
+int graphParseEdgeArgument(const char *argument, long edge[2]) {
+    const char *end = argument + strlen(argument);
+    const char *position = scanNodeId(argument, end, &edge[0]);
+    if(position == NULL || position == end || *position != '-') {
+        return -1;
+    }
+    position = scanNodeId(position + 1, end, &edge[1]);
+    if(position == NULL || position != end) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parses the mapped content of a graph file into an edge list
+ *
+ * @param data Start of the file content
+ * @param size Size of the file content
+ * @param edgeList Output for the allocated edge list
+ * @param numEdges Output for the number of edges
+ * @param error Buffer of GRAPH_ERROR_SIZE bytes for the error message
+ * @return 0 on success, -1 on failure
+ */
+static int parseEdgeList(const char *data, size_t size, long (**edgeList)[2], size_t *numEdges, char *error) {
+    // Typical edge lines are at least eight bytes long, so this rarely has to grow
+    size_t capacity = size / 8 > INITIAL_EDGE_CAPACITY ? size / 8 : INITIAL_EDGE_CAPACITY;
+    size_t count = 0;
+    long (*edges)[2] = malloc(sizeof(long[2]) * capacity);
+    if(edges == NULL) {
+        snprintf(error, GRAPH_ERROR_SIZE, "Failed to allocate edge list: %s", strerror(errno));
+        return -1;
+    }
+
+    const char *position = data;
+    const char *end = data + size;
+    size_t line = 0;
+    while(position < end) {
+        ++line;
+        position = skipBlanks(position, end);
+        if(position == end || *position == '\n') {
+            ++position;
+            continue;
+        }
+        if(*position == 'c' || *position == 'p' || *position == '#' || *position == '%') {
+            const char *lineEnd = memchr(position, '\n', end - position);
+            position = lineEnd != NULL ? lineEnd + 1 : end;
+            continue;
+        }
+        if(*position == 'e') {
+            position = skipBlanks(position + 1, end);
+        }
+
+        if(count == capacity) {
+            capacity *= 2;
+            long (*grown)[2] = realloc(edges, sizeof(long[2]) * capacity);
+            if(grown == NULL) {
+                snprintf(error, GRAPH_ERROR_SIZE, "Failed to grow edge list: %s", strerror(errno));
+                free(edges);
+                return -1;
+            }
+            edges = grown;
+        }
+
+        // Blanks never include the line break, so a valid edge ends exactly at the end of its line
+        position = scanEdge(position, end, edges[count]);
+        if(position == NULL || (position != end && *position != '\n')) {
+            snprintf(error, GRAPH_ERROR_SIZE, "Malformed edge on line %zu", line);
+            free(edges);
+            return -1;
+        }
+        ++count;
+        ++position;
+    }
+
+    *edgeList = edges;
+    *numEdges = count;
+    return 0;
+}
+
+int graphLoadFile(graph_t *graph, const char *path, char *error) {
+    memset(graph, 0, sizeof(*graph));
+
+    int fd;
+    if((fd = open(path, O_RDONLY)) == -1) {
+        snprintf(error, GRAPH_ERROR_SIZE, "Failed to open %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) == -1) {
+        snprintf(error, GRAPH_ERROR_SIZE, "Failed to stat %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    if(fileStat.st_size == 0) {
+        snprintf(error, GRAPH_ERROR_SIZE, "The graph file %s is empty", path);
+        close(fd);
+        return -1;
+    }
+
+    const char *data = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    if(data == MAP_FAILED) {
+        snprintf(error, GRAPH_ERROR_SIZE, "Failed to map %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    madvise((void*) data, fileStat.st_size, MADV_SEQUENTIAL);
+
+    long (*edgeList)[2] = NULL;
+    size_t numEdges = 0;
+    int result = parseEdgeList(data, fileStat.st_size, &edgeList, &numEdges, error);
+    munmap((void*) data, fileStat.st_size);
+    if(result == -1) {
+        return -1;
+    }
+
+    result = graphFromEdgeList(graph, (const long (*)[2]) edgeList, numEdges, error);
+    free(edgeList);
+    return result;
+}
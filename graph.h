@@ -0,0 +1,168 @@
+/**
+ * @file graph.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ * 
+ * @brief Headder file for the in memory graph representation and the graph parsers
+ *
+ **/
+
+#ifndef GRAPH_H_FILE
+#define GRAPH_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Size of the buffers the graph functions write their error messages to
+ */
+#define GRAPH_ERROR_SIZE 256
+
+/**
+ * @brief Graph with nodes relabeled to the dense range [0, numNodes).
+ *        Edges are unique, have no self-loops and are stored with the smaller index first.
+ *        Freshly built graphs have sorted node ids and edges, live updates append nodes and edges out of order.
+ *        Once graphBuildIndex was called, nodeTable and edgeTable are linear probing hash tables of the node ids and
+ *        the edges. Their slots hold the node or edge index plus one, 0 marks an empty slot.
+ * 
+ */
+typedef struct {
+    size_t numNodes;
+    size_t numEdges;
+    long *nodeIds;
+    uint32_t (*edges)[2];
+    size_t nodeCapacity;
+    size_t edgeCapacity;
+    uint32_t *nodeTable;
+    size_t nodeTableMask;
+    uint32_t *edgeTable;
+    size_t edgeTableMask;
+} graph_t;
+
+/**
+ * @brief Neighbors of every node of a graph in compressed sparse row form.
+ *        The neighbors of node are neighbors[offsets[node]] to neighbors[offsets[node + 1] - 1],
+ *        edgeIds holds the index of the edge to each of them in the graph
+ * 
+ */
+typedef struct {
+    size_t numNodes;
+    uint32_t *offsets;
+    uint32_t *neighbors;
+    uint32_t *edgeIds;
+} graph_adjacency_t;
+
+/**
+ * @brief Builds a graph from a list of edges between arbitrary node ids.
+ *        The node ids are sorted and every edge is rewritten to the index of its nodes in that order.
+ *        Duplicate edges are dropped, self-loops are rejected.
+ * 
+ * @param graph The graph to fill
+ * @param edgeList The edges as pairs of node ids
+ * @param numEdges The number of edges in edgeList
+ * @param error Buffer of GRAPH_ERROR_SIZE bytes for the error message
+ * @return 0 on success, -1 on failure
+ */
+int graphFromEdgeList(graph_t *graph, const long (*edgeList)[2], size_t numEdges, char *error);
+
+/**
+ * @brief Parses a single command line edge of the form {node1}-{node2}
+ * 
+ * @param argument The argument to parse
+ * @param edge Output for the two node ids
+ * @return 0 on success, -1 if the argument is not a valid edge
+ */
+int graphParseEdgeArgument(const char *argument, long edge[2]);
+
+/**
+ * @brief Loads a graph from a text edge list or a DIMACS .col file.
+ *        Every line is either empty, a comment (c, #, %), a DIMACS problem line (p),
+ *        a DIMACS edge (e u v) or a plain edge (u v, u-v or u,v).
+ * 
+ * @param graph The graph to fill
+ * @param path Path of the file
+ * @param error Buffer of GRAPH_ERROR_SIZE bytes for the error message
+ * @return 0 on success, -1 on failure
+ */
+int graphLoadFile(graph_t *graph, const char *path, char *error);
+
+/**
+ * @brief Builds the hash tables of the node ids and the edges the update functions need. The tables are kept up to
+ *        date by the updates afterwards, graphs that are never updated do not pay for them
+ * 
+ * @param graph The graph
+ * @return 0 on success, -1 with errno set on failure
+ */
+int graphBuildIndex(graph_t *graph);
+
+/**
+ * @brief Looks up the dense index of a node id in constant expected time. Needs graphBuildIndex
+ * 
+ * @param graph The graph
+ * @param id The node id
+ * @return The index or -1 if the graph has no such node
+ */
+long graphFindNode(const graph_t *graph, long id);
+
+/**
+ * @brief Appends a node, the caller makes sure it does not exist yet. Needs graphBuildIndex
+ * 
+ * @param graph The graph
+ * @param id The node id
+ * @return The index of the new node or -1 with errno set on failure
+ */
+long graphAddNode(graph_t *graph, long id);
+
+/**
+ * @brief Looks up the index of the edge between two nodes in constant expected time. Needs graphBuildIndex
+ * 
+ * @param graph The graph
+ * @param u Index of one node
+ * @param v Index of the other node
+ * @return The edge index or -1 if the nodes are not adjacent
+ */
+long graphFindEdge(const graph_t *graph, uint32_t u, uint32_t v);
+
+/**
+ * @brief Appends an edge between two different nodes, the caller makes sure it does not exist yet. Needs graphBuildIndex
+ * 
+ * @param graph The graph
+ * @param u Index of one node
+ * @param v Index of the other node
+ * @return 0 on success, -1 with errno set on failure
+ */
+int graphAddEdge(graph_t *graph, uint32_t u, uint32_t v);
+
+/**
+ * @brief Removes an edge by moving the last edge into its place. Needs graphBuildIndex
+ * 
+ * @param graph The graph
+ * @param edge Index of the edge to remove
+ */
+void graphRemoveEdge(graph_t *graph, size_t edge);
+
+/**
+ * @brief Builds the adjacency of a graph. Updates of the graph afterwards are not reflected
+ * 
+ * @param adjacency The adjacency to fill
+ * @param graph The graph
+ * @return 0 on success, -1 with errno set on failure
+ */
+int graphBuildAdjacency(graph_adjacency_t *adjacency, const graph_t *graph);
+
+/**
+ * @brief Frees the memory of an adjacency
+ * 
+ * @param adjacency The adjacency to free
+ */
+void graphFreeAdjacency(graph_adjacency_t *adjacency);
+
+/**
+ * @brief Frees all memory of the graph and resets it to an empty graph
+ * 
+ * @param graph The graph to free
+ */
+void graphFree(graph_t *graph);
+
+#endif
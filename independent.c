@@ -0,0 +1,474 @@
+/**
+ * @file independent.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Bron-Kerbosch search over the maximal independent sets with an incremental bipartiteness check
+ *
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+
+#include "independent.h"
+
+#define STATE_SEARCHING 0
+#define STATE_WRITING 1
+#define STATE_FOUND 2
+
+/**
+ * @brief Every frame holds the candidates, the excluded nodes and the branches of one depth
+ */
+#define FRAME_CANDIDATES 0
+#define FRAME_EXCLUDED 1
+#define FRAME_BRANCHES 2
+#define FRAME_SETS 3
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Bitsets
+
+static inline bool testBit(const uint64_t *set, uint32_t node) {
+    return (set[node >> 6] >> (node & 63)) & 1;
+}
+
+static inline void setBit(uint64_t *set, uint32_t node) {
+    set[node >> 6] |= 1ULL << (node & 63);
+}
+
+static inline void clearBit(uint64_t *set, uint32_t node) {
+    set[node >> 6] &= ~(1ULL << (node & 63));
+}
+
+/**
+ * @brief Returns one set of the frame of a depth
+ */
+static inline uint64_t* frameSet(const independent_worker_t *worker, size_t depth, int set) {
+    return &worker -> frames[(depth * FRAME_SETS + set) * worker -> independent -> numWords];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Left over nodes
+
+/**
+ * @brief Returns the root of the component of a node and the parity of the node relative to it
+ */
+static uint32_t findRoot(const independent_worker_t *worker, uint32_t node, uint8_t *parity) {
+    uint8_t sum = 0;
+    while(worker -> parent[node] != node) {
+        sum ^= worker -> parity[node];
+        node = worker -> parent[node];
+    }
+    *parity = sum;
+    return node;
+}
+
+/**
+ * @brief Puts two adjacent left over nodes on opposite sides. The smaller component is hung below the root of the
+ *        larger one without path compression, so the union can be undone
+ *
+ * @return false if both already are on the same side
+ */
+static bool uniteOpposite(independent_worker_t *worker, uint32_t u, uint32_t v) {
+    uint8_t parityU;
+    uint8_t parityV;
+    uint32_t rootU = findRoot(worker, u, &parityU);
+    uint32_t rootV = findRoot(worker, v, &parityV);
+    if(rootU == rootV) {
+        return parityU != parityV;
+    }
+    if(worker -> size[rootU] > worker -> size[rootV]) {
+        uint32_t root = rootU;
+        rootU = rootV;
+        rootV = root;
+    }
+    worker -> parent[rootU] = rootV;
+    worker -> parity[rootU] = parityU ^ parityV ^ 1;
+    worker -> size[rootV] += worker -> size[rootU];
+    worker -> unionStack[worker -> unionStackSize++] = rootU;
+    return true;
+}
+
+/**
+ * @brief Marks a node as left over and joins it with its left over neighbors
+ *
+ * @return false if the left over nodes are no longer bipartite
+ */
+static bool leaveOver(independent_worker_t *worker, uint32_t node) {
+    const graph_adjacency_t *adjacency = worker -> independent -> adjacency;
+    worker -> leftOver[node] = 1;
+    worker -> leftOverStack[worker -> leftOverStackSize++] = node;
+    for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+        uint32_t neighbor = adjacency -> neighbors[i];
+        if(worker -> leftOver[neighbor] && !uniteOpposite(worker, node, neighbor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Undoes the left over nodes and the unions back to the given stack sizes
+ */
+static void rollback(independent_worker_t *worker, size_t leftOverMark, size_t unionMark) {
+    while(worker -> leftOverStackSize > leftOverMark) {
+        worker -> leftOver[worker -> leftOverStack[--worker -> leftOverStackSize]] = 0;
+    }
+    while(worker -> unionStackSize > unionMark) {
+        uint32_t root = worker -> unionStack[--worker -> unionStackSize];
+        worker -> size[worker -> parent[root]] -= worker -> size[root];
+        worker -> parent[root] = root;
+        worker -> parity[root] = 0;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Search
+
+/**
+ * @brief Checks whether the search was stopped or some worker already found a coloring
+ */
+static inline bool stopped(independent_t *independent) {
+    return __atomic_load_n(&independent -> stop, __ATOMIC_RELAXED) || __atomic_load_n(&independent -> state, __ATOMIC_RELAXED) != STATE_SEARCHING;
+}
+
+/**
+ * @brief Writes the coloring of the first worker that gets here, color 0 for the set and the sides of the left over
+ *        nodes as colors 1 and 2
+ */
+static void recordColoring(independent_worker_t *worker) {
+    independent_t *independent = worker -> independent;
+    int expected = STATE_SEARCHING;
+    if(!__atomic_compare_exchange_n(&independent -> state, &expected, STATE_WRITING, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return;
+    }
+    for(uint32_t node = 0; node < independent -> adjacency -> numNodes; ++node) {
+        uint8_t parity;
+        findRoot(worker, node, &parity);
+        independent -> colors[node] = worker -> inSet[node] ? 0 : (int8_t) (1 + parity);
+    }
+    __atomic_store_n(&independent -> state, STATE_FOUND, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Picks the pivot among the candidates and excluded nodes that leaves the fewest branches, the pivot itself
+ *        if it is a candidate and its neighbors among the candidates, and writes them into the branch set
+ */
+static void choosePivot(const independent_t *independent, const uint64_t *candidates, const uint64_t *excluded, uint64_t *branches) {
+    size_t numWords = independent -> numWords;
+    size_t fewest = SIZE_MAX;
+    uint32_t pivot = 0;
+    for(size_t word = 0; word < numWords && fewest > 0; ++word) {
+        for(uint64_t bits = candidates[word] | excluded[word]; bits != 0 && fewest > 0; bits &= bits - 1) {
+            uint32_t node = (uint32_t) (word * 64 + __builtin_ctzll(bits));
+            const uint64_t *row = &independent -> rows[node * numWords];
+            size_t count = testBit(candidates, node);
+            for(size_t w = 0; w < numWords && count < fewest; ++w) {
+                count += __builtin_popcountll(candidates[w] & row[w]);
+            }
+            if(count < fewest) {
+                fewest = count;
+                pivot = node;
+            }
+        }
+    }
+
+    const uint64_t *row = &independent -> rows[pivot * numWords];
+    for(size_t w = 0; w < numWords; ++w) {
+        branches[w] = candidates[w] & row[w];
+    }
+    if(testBit(candidates, pivot)) {
+        setBit(branches, pivot);
+    }
+}
+
+static void expand(independent_worker_t *worker, size_t depth);
+
+/**
+ * @brief Adds a candidate to the set. Its neighbors among the candidates can no longer join and are left over
+ *
+ * @param worker The worker
+ * @param depth Depth of the frame the node is a candidate in
+ * @param node The node
+ */
+static void branchOn(independent_worker_t *worker, size_t depth, uint32_t node) {
+    independent_t *independent = worker -> independent;
+    size_t numWords = independent -> numWords;
+    const uint64_t *row = &independent -> rows[node * numWords];
+    const uint64_t *candidates = frameSet(worker, depth, FRAME_CANDIDATES);
+    const uint64_t *excluded = frameSet(worker, depth, FRAME_EXCLUDED);
+    uint64_t *nextCandidates = frameSet(worker, depth + 1, FRAME_CANDIDATES);
+    uint64_t *nextExcluded = frameSet(worker, depth + 1, FRAME_EXCLUDED);
+    size_t leftOverMark = worker -> leftOverStackSize;
+    size_t unionMark = worker -> unionStackSize;
+
+    bool bipartite = true;
+    for(size_t w = 0; w < numWords; ++w) {
+        nextCandidates[w] = candidates[w] & ~row[w];
+        nextExcluded[w] = excluded[w] & ~row[w];
+        for(uint64_t bits = candidates[w] & row[w]; bits != 0 && bipartite; bits &= bits - 1) {
+            bipartite = leaveOver(worker, (uint32_t) (w * 64 + __builtin_ctzll(bits)));
+        }
+    }
+    clearBit(nextCandidates, node);
+    clearBit(nextExcluded, node);
+
+    if(bipartite) {
+        worker -> inSet[node] = 1;
+        expand(worker, depth + 1);
+        worker -> inSet[node] = 0;
+    }
+    rollback(worker, leftOverMark, unionMark);
+}
+
+/**
+ * @brief Branches on every node the pivot leaves. A branch node that was searched is excluded from its siblings, so
+ *        it is left over for them
+ *
+ * @param worker The worker
+ * @param depth Depth of the frame with the candidates and the excluded nodes
+ */
+static void expand(independent_worker_t *worker, size_t depth) {
+    independent_t *independent = worker -> independent;
+    size_t numWords = independent -> numWords;
+    uint64_t *candidates = frameSet(worker, depth, FRAME_CANDIDATES);
+    uint64_t *excluded = frameSet(worker, depth, FRAME_EXCLUDED);
+    uint64_t *branches = frameSet(worker, depth, FRAME_BRANCHES);
+    if(stopped(independent)) {
+        return;
+    }
+
+    // Without candidates every node is in the set or left over, and the left over nodes are bipartite
+    bool empty = true;
+    for(size_t w = 0; w < numWords && empty; ++w) {
+        empty = candidates[w] == 0;
+    }
+    if(empty) {
+        recordColoring(worker);
+        return;
+    }
+
+    choosePivot(independent, candidates, excluded, branches);
+    for(size_t w = 0; w < numWords; ++w) {
+        for(uint64_t bits = branches[w]; bits != 0; bits &= bits - 1) {
+            uint32_t node = (uint32_t) (w * 64 + __builtin_ctzll(bits));
+            branchOn(worker, depth, node);
+            if(stopped(independent)) {
+                return;
+            }
+            clearBit(candidates, node);
+            setBit(excluded, node);
+            // The caller undoes the nodes left over here
+            if(!leaveOver(worker, node)) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Searches one branch of the root. The branches before it are excluded and left over
+ *
+ * @return false if the branches up to this one already leave a graph that is not bipartite, so all later ones do too
+ */
+static bool searchBranch(independent_worker_t *worker, size_t branch) {
+    independent_t *independent = worker -> independent;
+    size_t numNodes = independent -> adjacency -> numNodes;
+    uint64_t *candidates = frameSet(worker, 0, FRAME_CANDIDATES);
+    uint64_t *excluded = frameSet(worker, 0, FRAME_EXCLUDED);
+    memset(candidates, 0, sizeof(uint64_t) * independent -> numWords);
+    memset(excluded, 0, sizeof(uint64_t) * independent -> numWords);
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        setBit(candidates, node);
+    }
+
+    bool bipartite = true;
+    for(size_t i = 0; i < branch && bipartite; ++i) {
+        clearBit(candidates, independent -> branches[i]);
+        setBit(excluded, independent -> branches[i]);
+        bipartite = leaveOver(worker, independent -> branches[i]);
+    }
+    if(bipartite) {
+        branchOn(worker, 0, independent -> branches[branch]);
+    }
+    rollback(worker, 0, 0);
+    return bipartite;
+}
+
+/**
+ * @brief Thread function of every worker. Takes branches of the root until none is left or the search is over
+ *
+ * @param argument The worker
+ * @return NULL
+ */
+static void* runWorker(void *argument) {
+    independent_worker_t *worker = argument;
+    independent_t *independent = worker -> independent;
+
+    while(!stopped(independent)) {
+        size_t branch = __atomic_fetch_add(&independent -> nextBranch, 1, __ATOMIC_RELAXED);
+        if(branch >= independent -> numBranches) {
+            break;
+        }
+        if(!searchBranch(worker, branch)) {
+            // Later branches leave over a superset of the nodes this one did
+            __atomic_store_n(&independent -> nextBranch, independent -> numBranches, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    __atomic_add_fetch(&independent -> numFinished, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Workers
+
+/**
+ * @brief Allocates the frames and the union-find of a worker
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int createWorker(independent_worker_t *worker, independent_t *independent) {
+    size_t numNodes = independent -> adjacency -> numNodes;
+    size_t count = numNodes > 0 ? numNodes : 1;
+    memset(worker, 0, sizeof(*worker));
+    worker -> independent = independent;
+    worker -> frames = calloc((independent -> maxDepth + 1) * FRAME_SETS * independent -> numWords, sizeof(uint64_t));
+    worker -> parent = malloc(sizeof(uint32_t) * count);
+    worker -> size = malloc(sizeof(uint32_t) * count);
+    worker -> parity = calloc(count, 1);
+    worker -> inSet = calloc(count, 1);
+    worker -> leftOver = calloc(count, 1);
+    worker -> leftOverStack = malloc(sizeof(uint32_t) * count);
+    worker -> unionStack = malloc(sizeof(uint32_t) * count);
+    if(worker -> frames == NULL || worker -> parent == NULL || worker -> size == NULL || worker -> parity == NULL ||
+        worker -> inSet == NULL || worker -> leftOver == NULL || worker -> leftOverStack == NULL || worker -> unionStack == NULL) {
+        return -1;
+    }
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        worker -> parent[node] = node;
+        worker -> size[node] = 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Frees the frames and the union-find of a worker
+ */
+static void freeWorker(independent_worker_t *worker) {
+    free(worker -> frames);
+    free(worker -> parent);
+    free(worker -> size);
+    free(worker -> parity);
+    free(worker -> inSet);
+    free(worker -> leftOver);
+    free(worker -> leftOverStack);
+    free(worker -> unionStack);
+}
+
+int independentCreate(independent_t *independent, const graph_adjacency_t *adjacency, int numThreads) {
+    memset(independent, 0, sizeof(*independent));
+    if(numThreads < 1 || numThreads > INDEPENDENT_MAX_THREADS || adjacency -> numNodes > INDEPENDENT_MAX_NODES) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    size_t numNodes = adjacency -> numNodes;
+    independent -> adjacency = adjacency;
+    independent -> numWords = (numNodes + 63) / 64 > 0 ? (numNodes + 63) / 64 : 1;
+    independent -> rows = calloc(independent -> numWords * (numNodes > 0 ? numNodes : 1), sizeof(uint64_t));
+    independent -> branches = malloc(sizeof(uint32_t) * (numNodes > 0 ? numNodes : 1));
+    independent -> colors = malloc(numNodes > 0 ? numNodes : 1);
+    independent -> threads = malloc(sizeof(pthread_t) * numThreads);
+    // Workers are written by different threads and must not share cache lines
+    void *workers = NULL;
+    int workersResult = posix_memalign(&workers, CACHE_LINE_SIZE, sizeof(independent_worker_t) * numThreads);
+    independent -> workers = workersResult == 0 ? workers : NULL;
+    if(independent -> rows == NULL || independent -> branches == NULL || independent -> colors == NULL ||
+        independent -> threads == NULL || independent -> workers == NULL) {
+        independentFree(independent);
+        errno = workersResult != 0 ? workersResult : ENOMEM;
+        return -1;
+    }
+
+    // The set holds a node of least degree only together with none of its neighbors, which bounds the depth
+    uint32_t pivot = 0;
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        uint64_t *row = &independent -> rows[node * independent -> numWords];
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            setBit(row, adjacency -> neighbors[i]);
+        }
+        if(adjacency -> offsets[node + 1] - adjacency -> offsets[node] < adjacency -> offsets[pivot + 1] - adjacency -> offsets[pivot]) {
+            pivot = node;
+        }
+    }
+    independent -> maxDepth = numNodes > 0 ? numNodes - (adjacency -> offsets[pivot + 1] - adjacency -> offsets[pivot]) : 0;
+
+    // At the root the pivot of least degree leaves itself and its neighbors as first node choices
+    if(numNodes > 0) {
+        independent -> branches[independent -> numBranches++] = pivot;
+        for(uint32_t i = adjacency -> offsets[pivot]; i < adjacency -> offsets[pivot + 1]; ++i) {
+            independent -> branches[independent -> numBranches++] = adjacency -> neighbors[i];
+        }
+    } else {
+        independent -> state = STATE_FOUND;
+    }
+
+    for(int i = 0; i < numThreads; ++i) {
+        ++independent -> numWorkers;
+        if(createWorker(&independent -> workers[i], independent) == -1) {
+            independentFree(independent);
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int independentStart(independent_t *independent) {
+    // Signals have to reach the main thread
+    sigset_t allSignals;
+    sigset_t previousSignals;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousSignals);
+    int result = 0;
+    for(int i = 0; i < independent -> numWorkers && result == 0; ++i) {
+        result = pthread_create(&independent -> threads[independent -> numThreads], NULL, runWorker, &independent -> workers[i]);
+        if(result == 0) {
+            ++independent -> numThreads;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &previousSignals, NULL);
+    return result;
+}
+
+int independentPoll(independent_t *independent) {
+    // A worker that found a coloring wrote it before it finished
+    int numFinished = __atomic_load_n(&independent -> numFinished, __ATOMIC_ACQUIRE);
+    int state = __atomic_load_n(&independent -> state, __ATOMIC_ACQUIRE);
+    if(state == STATE_FOUND) {
+        return VERDICT_COLORABLE;
+    }
+    if(numFinished == independent -> numWorkers && state == STATE_SEARCHING) {
+        return VERDICT_UNCOLORABLE;
+    }
+    return VERDICT_UNKNOWN;
+}
+
+void independentFree(independent_t *independent) {
+    __atomic_store_n(&independent -> stop, true, __ATOMIC_RELAXED);
+    for(int i = 0; i < independent -> numThreads; ++i) {
+        pthread_join(independent -> threads[i], NULL);
+    }
+    for(int i = 0; i < independent -> numWorkers; ++i) {
+        freeWorker(&independent -> workers[i]);
+    }
+    free(independent -> rows);
+    free(independent -> branches);
+    free(independent -> colors);
+    free(independent -> threads);
+    free(independent -> workers);
+    memset(independent, 0, sizeof(*independent));
+}
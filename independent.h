@@ -0,0 +1,109 @@
+/**
+ * @file independent.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the exact 3-coloring search over the independent sets of a graph
+ * @details A graph is 3-colorable exactly when it has an independent set whose removal leaves a bipartite graph, and
+ *          that set can always be grown to a maximal one. The maximal independent sets are the maximal cliques of the
+ *          complement, which a Bron-Kerbosch search with pivoting enumerates over bitset rows of the adjacency. Nodes
+ *          that can no longer join the set will be left over, so they are added to a union-find with parity as soon
+ *          as they drop out of the candidates, and a branch ends the moment they stop being bipartite. Every branch of
+ *          the first node choice is a task, the worker threads take tasks until one finds a coloring or none is left.
+ *
+ **/
+
+#ifndef INDEPENDENT_H_FILE
+#define INDEPENDENT_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "commons.h"
+#include "graph.h"
+
+/**
+ * @brief Largest graph the search takes, the bitset rows need numNodes squared bits
+ */
+#define INDEPENDENT_MAX_NODES 4096
+
+#define INDEPENDENT_MAX_THREADS 16
+
+/**
+ * @brief Search state of one worker thread. The frames hold the candidate, excluded and branch sets of every depth
+ *
+ */
+typedef struct {
+    struct independent *independent;
+    uint64_t *frames;
+    uint32_t *parent;
+    uint32_t *size;
+    uint8_t *parity;
+    uint8_t *inSet;
+    uint8_t *leftOver;
+    uint32_t *leftOverStack;
+    size_t leftOverStackSize;
+    uint32_t *unionStack;
+    size_t unionStackSize;
+} CACHE_ALIGNED independent_worker_t;
+
+/**
+ * @brief The search with its threads. The first node choices are the branches of the pivot at the root
+ *
+ */
+typedef struct independent {
+    const graph_adjacency_t *adjacency;
+    size_t numWords;
+    uint64_t *rows;
+    size_t maxDepth;
+    uint32_t *branches;
+    size_t numBranches;
+    size_t nextBranch;
+    independent_worker_t *workers;
+    int numWorkers;
+    pthread_t *threads;
+    int numThreads;
+    int numFinished;
+    int state;
+    bool stop;
+    int8_t *colors;
+} independent_t;
+
+/**
+ * @brief Builds the bitset rows and the branches of the root
+ *
+ * @param independent The search to initialise
+ * @param adjacency The adjacency of the graph, has to outlive the search
+ * @param numThreads The number of worker threads, 1 to INDEPENDENT_MAX_THREADS
+ * @return 0 on success, -1 with errno set on failure, EINVAL if the graph has more than INDEPENDENT_MAX_NODES nodes
+ */
+int independentCreate(independent_t *independent, const graph_adjacency_t *adjacency, int numThreads);
+
+/**
+ * @brief Starts the worker threads
+ *
+ * @param independent The search
+ * @return 0 on success, an error number on failure
+ */
+int independentStart(independent_t *independent);
+
+/**
+ * @brief Looks whether the search is done
+ *
+ * @param independent The search
+ * @return VERDICT_COLORABLE with the coloring in independent -> colors, VERDICT_UNCOLORABLE once every branch was
+ *         exhausted, VERDICT_UNKNOWN while the search runs
+ */
+int independentPoll(independent_t *independent);
+
+/**
+ * @brief Stops and joins the threads and frees all memory
+ *
+ * @param independent The search to free
+ */
+void independentFree(independent_t *independent);
+
+#endif
@@ -0,0 +1,457 @@
+/**
+ * @file kernel.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ * 
+ * @brief Instantiation and selection of the specialised coloring kernels
+ *
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include "kernel.h"
+
+/**
+ * @brief The splitmix64 finalizer, spreads every input bit over the whole output
+ */
+static inline uint64_t mixHash(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Hash of a node having a color
+ */
+static inline uint64_t nodeColorHash(size_t node, int color) {
+    return mixHash(((uint64_t) node * KERNEL_MAX_COLORS + (uint64_t) color + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+/**
+ * @brief Whether the walk checks its candidates against the filter. Independent samples practically never repeat
+ */
+static inline bool filterActive(const kernel_t *kernel) {
+    return kernel -> filter != NULL && kernel -> restartInterval != 0;
+}
+
+/**
+ * @brief Recomputes the color hashes from the current coloring
+ */
+static void computeColorHashes(kernel_t *kernel) {
+    memset(kernel -> colorHashes, 0, sizeof(kernel -> colorHashes));
+    for(size_t node = 0; node < kernel -> numNodes; ++node) {
+        int color = kernelGetColor(kernel, node);
+        for(int target = 0; target < kernel -> numColors; ++target) {
+            kernel -> colorHashes[color][target] ^= nodeColorHash(node, target);
+        }
+    }
+}
+
+/**
+ * @brief Updates the color hashes for a node that was recolored
+ */
+static inline void moveColorHash(kernel_t *kernel, size_t node, int from, int to) {
+    for(int target = 0; target < kernel -> numColors; ++target) {
+        uint64_t hash = nodeColorHash(node, target);
+        kernel -> colorHashes[from][target] ^= hash;
+        kernel -> colorHashes[to][target] ^= hash;
+    }
+}
+
+/**
+ * @brief Finds the smallest hash over all assignments of the remaining colors to unused target colors
+ *
+ * @param kernel The kernel
+ * @param color The next color to assign
+ * @param used Bit mask of the target colors already assigned
+ * @param hash Hash of the colors assigned so far
+ * @return The smallest hash of all complete assignments
+ */
+static uint64_t minimumPermutationHash(const kernel_t *kernel, int color, unsigned used, uint64_t hash) {
+    if(color == kernel -> numColors) {
+        return hash;
+    }
+    uint64_t minimum = UINT64_MAX;
+    for(int target = 0; target < kernel -> numColors; ++target) {
+        if((used & (1u << target)) == 0) {
+            uint64_t candidate = minimumPermutationHash(kernel, color + 1, used | (1u << target), hash ^ kernel -> colorHashes[color][target]);
+            if(candidate < minimum) {
+                minimum = candidate;
+            }
+        }
+    }
+    return minimum;
+}
+
+/**
+ * @brief Returns the key of the current coloring from the color hashes
+ */
+static inline uint64_t currentColoringKey(const kernel_t *kernel) {
+    return mixHash(minimumPermutationHash(kernel, 0, 0, 0) ^ kernel -> filterSalt);
+}
+
+/**
+ * @brief Appends an edge that became monochromatic to the conflict list and counts it
+ */
+static inline void addConflict(kernel_t *kernel, uint32_t edge) {
+    kernel -> conflictPosition[edge] = (uint32_t) kernel -> currentCost;
+    kernel -> conflictList[kernel -> currentCost++] = edge;
+}
+
+/**
+ * @brief Removes an edge that is no longer monochromatic from the conflict list by moving the last entry into its place
+ *        and uncounts it
+ */
+static inline void removeConflict(kernel_t *kernel, uint32_t edge) {
+    uint32_t position = kernel -> conflictPosition[edge];
+    uint32_t last = kernel -> conflictList[--kernel -> currentCost];
+    kernel -> conflictList[position] = last;
+    kernel -> conflictPosition[last] = position;
+}
+
+#define KERNEL_COLORS 3
+#define KERNEL_INDEX_T uint16_t
+#define KERNEL_SUFFIX k3_u16
+#include "kernel_template.h"
+#undef KERNEL_COLORS
+#undef KERNEL_INDEX_T
+#undef KERNEL_SUFFIX
+
+#define KERNEL_COLORS 3
+#define KERNEL_INDEX_T uint32_t
+#define KERNEL_SUFFIX k3_u32
+#include "kernel_template.h"
+#undef KERNEL_COLORS
+#undef KERNEL_INDEX_T
+#undef KERNEL_SUFFIX
+
+#define KERNEL_COLORS 4
+#define KERNEL_INDEX_T uint16_t
+#define KERNEL_SUFFIX k4_u16
+#include "kernel_template.h"
+#undef KERNEL_COLORS
+#undef KERNEL_INDEX_T
+#undef KERNEL_SUFFIX
+
+#define KERNEL_COLORS 4
+#define KERNEL_INDEX_T uint32_t
+#define KERNEL_SUFFIX k4_u32
+#include "kernel_template.h"
+#undef KERNEL_COLORS
+#undef KERNEL_INDEX_T
+#undef KERNEL_SUFFIX
+
+/**
+ * @brief Copies the edges of the graph into an index array of the given width
+ * 
+ * @param graph The graph
+ * @param indexWidth Size of one node index in bytes, 2 or 4
+ * @return The allocated array or NULL with errno set
+ */
+static void* narrowEdges(const graph_t *graph, size_t indexWidth) {
+    void *edges = malloc(indexWidth * 2 * (graph -> numEdges > 0 ? graph -> numEdges : 1));
+    if(edges == NULL) {
+        return NULL;
+    }
+
+    for(size_t i = 0; i < graph -> numEdges; ++i) {
+        if(indexWidth == sizeof(uint16_t)) {
+            ((uint16_t*) edges)[2 * i] = (uint16_t) graph -> edges[i][0];
+            ((uint16_t*) edges)[2 * i + 1] = (uint16_t) graph -> edges[i][1];
+        } else {
+            ((uint32_t*) edges)[2 * i] = graph -> edges[i][0];
+            ((uint32_t*) edges)[2 * i + 1] = graph -> edges[i][1];
+        }
+    }
+
+    return edges;
+}
+
+/**
+ * @brief Sets the name and the functions of the variant for the color count and index width of the kernel
+ * 
+ * @param kernel The kernel with numColors set
+ * @param narrow Whether the edges use 16 bit indices
+ */
+static void selectVariant(kernel_t *kernel, bool narrow) {
+    if(kernel -> numColors == 3) {
+        kernel -> name = narrow ? "k3_u16" : "k3_u32";
+        kernel -> randomize = narrow ? randomize_k3_u16 : randomize_k3_u32;
+        kernel -> evaluate = narrow ? evaluate_k3_u16 : evaluate_k3_u32;
+        kernel -> evaluateWeighted = narrow ? evaluateWeighted_k3_u16 : evaluateWeighted_k3_u32;
+        kernel -> search = narrow ? search_k3_u16 : search_k3_u32;
+        kernel -> collectConflicts = narrow ? collectConflicts_k3_u16 : collectConflicts_k3_u32;
+    } else {
+        kernel -> name = narrow ? "k4_u16" : "k4_u32";
+        kernel -> randomize = narrow ? randomize_k4_u16 : randomize_k4_u32;
+        kernel -> evaluate = narrow ? evaluate_k4_u16 : evaluate_k4_u32;
+        kernel -> evaluateWeighted = narrow ? evaluateWeighted_k4_u16 : evaluateWeighted_k4_u32;
+        kernel -> search = narrow ? search_k4_u16 : search_k4_u32;
+        kernel -> collectConflicts = narrow ? collectConflicts_k4_u16 : collectConflicts_k4_u32;
+    }
+    kernel -> indexWidth = narrow ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+int kernelCreate(kernel_t *kernel, const graph_t *graph, int numColors) {
+    memset(kernel, 0, sizeof(*kernel));
+
+    if(numColors < KERNEL_MIN_COLORS || numColors > KERNEL_MAX_COLORS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    kernel -> numColors = numColors;
+    selectVariant(kernel, graph -> numNodes <= (size_t) UINT16_MAX + 1);
+    kernel -> numNodes = graph -> numNodes;
+    kernel -> numEdges = graph -> numEdges;
+    kernel -> edgeCapacity = graph -> numEdges > 0 ? graph -> numEdges : 1;
+    kernel -> packedSize = (graph -> numNodes + 3) / 4;
+    kernel -> currentCost = KERNEL_NO_COST;
+
+    if((kernel -> edges = narrowEdges(graph, kernel -> indexWidth)) == NULL) {
+        return -1;
+    }
+    if((kernel -> packedColors = calloc(kernel -> packedSize > 0 ? kernel -> packedSize : 1, 1)) == NULL) {
+        kernelFree(kernel);
+        return -1;
+    }
+
+    return 0;
+}
+
+void kernelSetStrategy(kernel_t *kernel, long restartInterval, int samplingBias) {
+    kernel -> restartInterval = restartInterval;
+    kernel -> samplingBias = samplingBias;
+    kernel -> currentCost = KERNEL_NO_COST;
+    kernel -> stepsSinceImprovement = 0;
+}
+
+/**
+ * @brief Reads the endpoint of an edge independent of the index width
+ */
+static uint32_t edgeEndpoint(const kernel_t *kernel, size_t edge, int end) {
+    if(kernel -> indexWidth == sizeof(uint16_t)) {
+        return ((const uint16_t*) kernel -> edges)[2 * edge + end];
+    }
+    return ((const uint32_t*) kernel -> edges)[2 * edge + end];
+}
+
+/**
+ * @brief Writes the endpoint of an edge independent of the index width
+ */
+static void setEdgeEndpoint(kernel_t *kernel, size_t edge, int end, uint32_t node) {
+    if(kernel -> indexWidth == sizeof(uint16_t)) {
+        ((uint16_t*) kernel -> edges)[2 * edge + end] = (uint16_t) node;
+    } else {
+        ((uint32_t*) kernel -> edges)[2 * edge + end] = node;
+    }
+}
+
+/**
+ * @brief Converts the edges of a 16 bit kernel to 32 bit indices and switches to the 32 bit variant
+ * 
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int widenEdges(kernel_t *kernel) {
+    uint32_t *edges = malloc(sizeof(uint32_t) * 2 * kernel -> edgeCapacity);
+    if(edges == NULL) {
+        return -1;
+    }
+    for(size_t i = 0; i < 2 * kernel -> numEdges; ++i) {
+        edges[i] = ((const uint16_t*) kernel -> edges)[i];
+    }
+    free(kernel -> edges);
+    kernel -> edges = edges;
+    selectVariant(kernel, false);
+    return 0;
+}
+
+int kernelAddNode(kernel_t *kernel, rng_state_t *rng) {
+    if(kernel -> indexWidth == sizeof(uint16_t) && kernel -> numNodes == (size_t) UINT16_MAX + 1 && widenEdges(kernel) == -1) {
+        return -1;
+    }
+
+    size_t packedSize = (kernel -> numNodes + 1 + 3) / 4;
+    if(packedSize > kernel -> packedSize) {
+        uint8_t *packedColors = realloc(kernel -> packedColors, packedSize);
+        if(packedColors == NULL) {
+            return -1;
+        }
+        packedColors[packedSize - 1] = 0;
+        kernel -> packedColors = packedColors;
+        kernel -> packedSize = packedSize;
+    }
+
+    // An isolated node adds no conflicts, only its share of the color hashes
+    int color = (int) rngBelow(rng, (uint32_t) kernel -> numColors);
+    kernelSetColor(kernel, kernel -> numNodes, color);
+    for(int target = 0; target < kernel -> numColors; ++target) {
+        kernel -> colorHashes[color][target] ^= nodeColorHash(kernel -> numNodes, target);
+    }
+    ++kernel -> numNodes;
+    return 0;
+}
+
+int kernelAddEdge(kernel_t *kernel, uint32_t u, uint32_t v) {
+    if(kernel -> numEdges == kernel -> edgeCapacity) {
+        void *edges = realloc(kernel -> edges, kernel -> indexWidth * 2 * kernel -> edgeCapacity * 2);
+        if(edges == NULL) {
+            return -1;
+        }
+        kernel -> edges = edges;
+        kernel -> edgeCapacity *= 2;
+    }
+
+    setEdgeEndpoint(kernel, kernel -> numEdges, 0, u < v ? u : v);
+    setEdgeEndpoint(kernel, kernel -> numEdges, 1, u < v ? v : u);
+    if(kernel -> currentCost != KERNEL_NO_COST && kernelGetColor(kernel, u) == kernelGetColor(kernel, v)) {
+        if(kernel -> currentCost < KERNEL_CONFLICT_SAMPLE) {
+            kernel -> conflictSample[kernel -> currentCost] = (uint32_t) kernel -> numEdges;
+        }
+        ++kernel -> currentCost;
+    }
+    ++kernel -> numEdges;
+    return 0;
+}
+
+/**
+ * @brief Drops a conflicting edge that is removed from the conflict sample
+ *
+ * @return false if the sample was full and the edge in it, no other conflict is known to take its place then
+ */
+static bool dropConflict(kernel_t *kernel, size_t edge) {
+    size_t sampled = kernel -> currentCost < KERNEL_CONFLICT_SAMPLE ? kernel -> currentCost : KERNEL_CONFLICT_SAMPLE;
+    for(size_t i = 0; i < sampled; ++i) {
+        if(kernel -> conflictSample[i] == edge) {
+            if(kernel -> currentCost > KERNEL_CONFLICT_SAMPLE) {
+                return false;
+            }
+            kernel -> conflictSample[i] = kernel -> conflictSample[sampled - 1];
+            break;
+        }
+    }
+    --kernel -> currentCost;
+    return true;
+}
+
+void kernelRemoveEdge(kernel_t *kernel, size_t edge) {
+    uint32_t u = edgeEndpoint(kernel, edge, 0);
+    uint32_t v = edgeEndpoint(kernel, edge, 1);
+    bool complete = true;
+    if(kernel -> currentCost != KERNEL_NO_COST && kernelGetColor(kernel, u) == kernelGetColor(kernel, v)) {
+        complete = dropConflict(kernel, edge);
+    }
+
+    --kernel -> numEdges;
+    setEdgeEndpoint(kernel, edge, 0, edgeEndpoint(kernel, kernel -> numEdges, 0));
+    setEdgeEndpoint(kernel, edge, 1, edgeEndpoint(kernel, kernel -> numEdges, 1));
+    if(!complete) {
+        kernelRefreshConflicts(kernel);
+        return;
+    }
+
+    // The last edge moved into the place of the removed one
+    if(kernel -> currentCost != KERNEL_NO_COST) {
+        size_t sampled = kernel -> currentCost < KERNEL_CONFLICT_SAMPLE ? kernel -> currentCost : KERNEL_CONFLICT_SAMPLE;
+        for(size_t i = 0; i < sampled; ++i) {
+            if(kernel -> conflictSample[i] == kernel -> numEdges) {
+                kernel -> conflictSample[i] = (uint32_t) edge;
+            }
+        }
+    }
+}
+
+void kernelRefreshConflicts(kernel_t *kernel) {
+    if(kernel -> currentCost == KERNEL_NO_COST) {
+        return;
+    }
+    if(kernel -> adjacency != NULL) {
+        kernel -> collectConflicts(kernel);
+    } else if(kernel -> edgeWeights != NULL) {
+        kernel -> currentWeight = kernel -> evaluateWeighted(kernel, kernel -> conflictSample, KERNEL_CONFLICT_SAMPLE, SIZE_MAX, &kernel -> currentCost);
+    } else {
+        kernel -> currentCost = kernel -> evaluate(kernel, kernel -> conflictSample, KERNEL_CONFLICT_SAMPLE, kernel -> numEdges + 1);
+    }
+    kernel -> stepsSinceImprovement = 0;
+    if(filterActive(kernel)) {
+        computeColorHashes(kernel);
+    }
+}
+
+void kernelAdoptColoring(kernel_t *kernel) {
+    // Any cost lets the refresh run, it is replaced by the one of the new coloring
+    kernel -> currentCost = 0;
+    kernelRefreshConflicts(kernel);
+}
+
+void kernelSetConstruction(kernel_t *kernel, kernel_construct_t construct, void *context) {
+    kernel -> construct = construct;
+    kernel -> constructContext = context;
+    kernel -> currentCost = KERNEL_NO_COST;
+    kernel -> stepsSinceImprovement = 0;
+}
+
+void kernelSetFilter(kernel_t *kernel, coloring_filter_t *filter, uint64_t salt) {
+    kernel -> filter = filter;
+    kernel -> filterSalt = salt;
+    computeColorHashes(kernel);
+}
+
+void kernelSetEdgeWeights(kernel_t *kernel, const uint8_t *weights) {
+    kernel -> edgeWeights = weights;
+    if(weights == NULL) {
+        // The number of conflicts and their sample do not depend on the weights
+        kernel -> currentWeight = 0;
+        return;
+    }
+    kernelRefreshConflicts(kernel);
+}
+
+int kernelSetAdjacency(kernel_t *kernel, const graph_adjacency_t *adjacency) {
+    // The walk keeps only the list up to date, so the sample is taken from it before the list goes away
+    if(kernel -> adjacency != NULL && kernel -> restartInterval != 0 && kernel -> currentCost != KERNEL_NO_COST) {
+        size_t sampled = kernel -> currentCost < KERNEL_CONFLICT_SAMPLE ? kernel -> currentCost : KERNEL_CONFLICT_SAMPLE;
+        memcpy(kernel -> conflictSample, kernel -> conflictList, sizeof(uint32_t) * sampled);
+    }
+    free(kernel -> conflictList);
+    free(kernel -> conflictPosition);
+    kernel -> conflictList = NULL;
+    kernel -> conflictPosition = NULL;
+    kernel -> adjacency = NULL;
+    if(adjacency == NULL) {
+        return 0;
+    }
+
+    size_t capacity = kernel -> numEdges > 0 ? kernel -> numEdges : 1;
+    kernel -> conflictList = malloc(sizeof(uint32_t) * capacity);
+    kernel -> conflictPosition = malloc(sizeof(uint32_t) * capacity);
+    if(kernel -> conflictList == NULL || kernel -> conflictPosition == NULL) {
+        free(kernel -> conflictList);
+        free(kernel -> conflictPosition);
+        kernel -> conflictList = NULL;
+        kernel -> conflictPosition = NULL;
+        return -1;
+    }
+    kernel -> adjacency = adjacency;
+    if(kernel -> currentCost != KERNEL_NO_COST) {
+        kernel -> collectConflicts(kernel);
+    }
+    return 0;
+}
+
+uint64_t kernelColoringKey(kernel_t *kernel) {
+    computeColorHashes(kernel);
+    return currentColoringKey(kernel);
+}
+
+void kernelFree(kernel_t *kernel) {
+    free(kernel -> edges);
+    free(kernel -> packedColors);
+    free(kernel -> conflictList);
+    free(kernel -> conflictPosition);
+    memset(kernel, 0, sizeof(*kernel));
+}
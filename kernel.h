@@ -0,0 +1,242 @@
+/**
+ * @file kernel.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ * 
+ * @brief Headder file for the specialised coloring kernels
+ * @details Colors are packed with two bits per node. The kernels are generated from kernel_template.h
+ *          for every combination of color count (3, 4) and node index width (16 bit, 32 bit).
+ *
+ **/
+
+#ifndef KERNEL_H_FILE
+#define KERNEL_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+#include "rng.h"
+#include "filter.h"
+
+#define KERNEL_MIN_COLORS 3
+#define KERNEL_MAX_COLORS 4
+
+/**
+ * @brief Number of conflicting edges the kernel remembers of its current coloring. Bounds maxConflicts of the search
+ */
+#define KERNEL_CONFLICT_SAMPLE 64
+
+/**
+ * @brief Cost of a kernel that has no current coloring yet
+ */
+#define KERNEL_NO_COST SIZE_MAX
+
+typedef struct kernel kernel_t;
+
+/**
+ * @brief Builds a coloring into the kernel instead of drawing a uniform one
+ */
+typedef void (*kernel_construct_t)(void *context, kernel_t *kernel, rng_state_t *rng);
+
+/**
+ * @brief A kernel bound to one graph together with the coloring it works on and the state of its search.
+ *        With a restart interval of 0 the search samples independent uniform colorings. Otherwise it walks from the
+ *        current coloring by recoloring single nodes, picking an endpoint of a conflicting edge with samplingBias percent
+ *        probability, and restarts after restartInterval steps without improvement.
+ *        With a construction set, samples and restarts start from a constructed coloring instead of a uniform one.
+ *        With a filter attached, the walk skips candidates whose key is in the filter without evaluating them.
+ *        colorHashes[c][d] is the xor of the hashes of all nodes of color c as if they had color d, so the key of
+ *        every permutation of the colors follows from it and a recoloring updates it in 2 * numColors steps.
+ *        With edge weights attached, the walk minimises the summed weight of the conflicting edges, currentWeight,
+ *        while currentCost stays the number of conflicts that decides whether a coloring is a result.
+ *        With an adjacency attached, the walk keeps every conflicting edge in conflictList, with its index there in
+ *        conflictPosition, and prices a recoloring over the edges of the node instead of scanning all edges.
+ *        conflictSample then only holds the first conflicts of the list after a search or a refresh.
+ * 
+ */
+struct kernel {
+    const char *name;
+    int numColors;
+    size_t numNodes;
+    size_t numEdges;
+    size_t edgeCapacity;
+    size_t indexWidth;
+    void *edges;
+    uint8_t *packedColors;
+    size_t packedSize;
+
+    long restartInterval;
+    int samplingBias;
+    size_t currentCost;
+    long stepsSinceImprovement;
+    uint32_t conflictSample[KERNEL_CONFLICT_SAMPLE];
+    uint32_t candidateSample[KERNEL_CONFLICT_SAMPLE];
+
+    coloring_filter_t *filter;
+    uint64_t filterSalt;
+    long filterSkips;
+    uint64_t colorHashes[KERNEL_MAX_COLORS][KERNEL_MAX_COLORS];
+
+    kernel_construct_t construct;
+    void *constructContext;
+
+    const uint8_t *edgeWeights;
+    size_t currentWeight;
+
+    const graph_adjacency_t *adjacency;
+    uint32_t *conflictList;
+    uint32_t *conflictPosition;
+
+    void (*randomize)(kernel_t *kernel, rng_state_t *rng);
+    size_t (*evaluate)(const kernel_t *kernel, uint32_t *conflicts, size_t maxRecorded, size_t limit);
+    size_t (*evaluateWeighted)(const kernel_t *kernel, uint32_t *conflicts, size_t maxRecorded, size_t limit, size_t *count);
+    size_t (*search)(kernel_t *kernel, rng_state_t *rng, uint32_t *conflicts, size_t maxConflicts, long maxIterations);
+    void (*collectConflicts)(kernel_t *kernel);
+};
+
+/**
+ * @brief Picks the narrowest kernel variant for the graph and number of colors and copies the edges into it
+ * 
+ * @param kernel The kernel to initialise
+ * @param graph The graph the kernel works on
+ * @param numColors The number of colors, KERNEL_MIN_COLORS to KERNEL_MAX_COLORS
+ * @return 0 on success, -1 with errno set on failure
+ */
+int kernelCreate(kernel_t *kernel, const graph_t *graph, int numColors);
+
+/**
+ * @brief Sets the search parameters and discards the current coloring so the next search starts from scratch
+ * 
+ * @param kernel The kernel
+ * @param restartInterval Steps without improvement before a restart, 0 for independent sampling
+ * @param samplingBias Percent probability to recolor an endpoint of a conflicting edge instead of a random node
+ */
+void kernelSetStrategy(kernel_t *kernel, long restartInterval, int samplingBias);
+
+/**
+ * @brief Appends a node with a random color, mirroring graphAddNode. Switches to the 32 bit variant once the nodes
+ *        no longer fit into 16 bit indices
+ * 
+ * @param kernel The kernel
+ * @param rng The random stream for the color of the node
+ * @return 0 on success, -1 with errno set on failure
+ */
+int kernelAddNode(kernel_t *kernel, rng_state_t *rng);
+
+/**
+ * @brief Appends an edge, mirroring graphAddEdge so edge indices of the kernel and the graph stay the same.
+ *        The cost and the conflict sample of the current coloring are updated for the edge alone. The adjacency has
+ *        to be detached
+ * 
+ * @param kernel The kernel
+ * @param u Index of one node
+ * @param v Index of the other node
+ * @return 0 on success, -1 with errno set on failure
+ */
+int kernelAddEdge(kernel_t *kernel, uint32_t u, uint32_t v);
+
+/**
+ * @brief Removes an edge by moving the last edge into its place, mirroring graphRemoveEdge.
+ *        The cost and the conflict sample of the current coloring are updated for the two edges alone, unless the
+ *        removed edge is one of a full sample. Edge weights and the adjacency have to be detached
+ * 
+ * @param kernel The kernel
+ * @param edge Index of the edge to remove
+ */
+void kernelRemoveEdge(kernel_t *kernel, size_t edge);
+
+/**
+ * @brief Recomputes the cost and the conflict sample of the current coloring after the edges changed.
+ *        The coloring itself is kept so the search continues where it was
+ * 
+ * @param kernel The kernel
+ */
+void kernelRefreshConflicts(kernel_t *kernel);
+
+/**
+ * @brief Computes the cost, the conflict sample and the color hashes of a coloring that was set node by node from
+ *        outside the search, which then continues from it instead of restarting
+ * 
+ * @param kernel The kernel
+ */
+void kernelAdoptColoring(kernel_t *kernel);
+
+/**
+ * @brief Sets how samples and restart colorings are drawn and discards the current coloring
+ * 
+ * @param kernel The kernel
+ * @param construct The construction, NULL for uniform colorings
+ * @param context Passed to the construction
+ */
+void kernelSetConstruction(kernel_t *kernel, kernel_construct_t construct, void *context);
+
+/**
+ * @brief Attaches a filter of known colorings to the walk of the kernel
+ * 
+ * @param kernel The kernel
+ * @param filter The filter, NULL to detach
+ * @param salt Mixed into every key, so the same coloring of another graph version has another key
+ */
+void kernelSetFilter(kernel_t *kernel, coloring_filter_t *filter, uint64_t salt);
+
+/**
+ * @brief Attaches weights to the edges, which the walk then minimises instead of the number of conflicts.
+ *        The current coloring is kept and its weight recomputed
+ * 
+ * @param kernel The kernel
+ * @param weights One weight per edge of the kernel, NULL to detach. Has to be detached before edges are added or removed
+ */
+void kernelSetEdgeWeights(kernel_t *kernel, const uint8_t *weights);
+
+/**
+ * @brief Attaches the adjacency of the graph, which lets the walk price a recoloring in the degree of the node.
+ *        The conflicts of the current coloring are collected again
+ * 
+ * @param kernel The kernel
+ * @param adjacency The adjacency with the edge ids of the graph of the kernel, NULL to detach. Has to be detached
+ *        before nodes or edges are added or removed
+ * @return 0 on success, -1 with errno set on failure
+ */
+int kernelSetAdjacency(kernel_t *kernel, const graph_adjacency_t *adjacency);
+
+/**
+ * @brief Returns the key of the current coloring, the same for every coloring that only differs by a permutation of the colors
+ * 
+ * @param kernel The kernel
+ * @return The key including the salt of the filter
+ */
+uint64_t kernelColoringKey(kernel_t *kernel);
+
+/**
+ * @brief Frees the memory of the kernel
+ * 
+ * @param kernel The kernel to free
+ */
+void kernelFree(kernel_t *kernel);
+
+/**
+ * @brief Returns the color of a node in the current coloring of the kernel
+ * 
+ * @param kernel The kernel
+ * @param node Dense index of the node
+ * @return The color in [0, numColors)
+ */
+static inline int kernelGetColor(const kernel_t *kernel, size_t node) {
+    return (kernel -> packedColors[node >> 2] >> ((node & 3) * 2)) & 3;
+}
+
+/**
+ * @brief Sets the color of a node in the current coloring of the kernel
+ * 
+ * @param kernel The kernel
+ * @param node Dense index of the node
+ * @param color The color in [0, numColors)
+ */
+static inline void kernelSetColor(kernel_t *kernel, size_t node, int color) {
+    int shift = (node & 3) * 2;
+    kernel -> packedColors[node >> 2] = (uint8_t) ((kernel -> packedColors[node >> 2] & ~(3 << shift)) | (color << shift));
+}
+
+#endif
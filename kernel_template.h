@@ -0,0 +1,324 @@
+/**
+ * @file kernel_template.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ * 
+ * @brief Template of the coloring kernels
+ * @details This file is included once per variant by kernel.c with KERNEL_COLORS, KERNEL_INDEX_T and KERNEL_SUFFIX defined.
+ *          It has no include guard on purpose.
+ *
+ **/
+
+#define KERNEL_CONCAT_INNER(name, suffix) name ## _ ## suffix
+#define KERNEL_CONCAT(name, suffix) KERNEL_CONCAT_INNER(name, suffix)
+#define KERNEL_NAME(name) KERNEL_CONCAT(name, KERNEL_SUFFIX)
+#define KERNEL_COLOR(packed, node) (((packed)[(node) >> 2] >> (((node) & 3) * 2)) & 3)
+
+/**
+ * @brief Draws a uniformly random coloring
+ * 
+ * @param kernel The kernel whose coloring is overwritten
+ * @param rng The random stream
+ */
+static void KERNEL_NAME(randomize)(kernel_t *kernel, rng_state_t *rng) {
+    uint8_t *packed = kernel -> packedColors;
+#if KERNEL_COLORS == 4
+    // Every two bit field is a valid color, so random bytes already are random colorings
+    size_t i = 0;
+    for(; i + 8 <= kernel -> packedSize; i += 8) {
+        uint64_t bits = rngNext(rng);
+        memcpy(packed + i, &bits, 8);
+    }
+    if(i < kernel -> packedSize) {
+        uint64_t bits = rngNext(rng);
+        memcpy(packed + i, &bits, kernel -> packedSize - i);
+    }
+#else
+    // Each 32 bit half yields four base three digits by repeated multiplication, one byte of colors
+    for(size_t i = 0; i < kernel -> packedSize; i += 2) {
+        uint64_t bits = rngNext(rng);
+        for(size_t half = 0; half < 2 && i + half < kernel -> packedSize; ++half) {
+            uint64_t fraction = (uint32_t) (bits >> (32 * half));
+            uint8_t byte = 0;
+            for(int field = 0; field < 4; ++field) {
+                fraction *= KERNEL_COLORS;
+                byte |= (uint8_t) ((fraction >> 32) << (field * 2));
+                fraction &= 0xFFFFFFFFULL;
+            }
+            packed[i + half] = byte;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Counts the monochromatic edges and records the first maxRecorded of them, stopping as soon as limit were found
+ * 
+ * @param kernel The kernel with the coloring to evaluate
+ * @param conflicts Output buffer for at least maxRecorded edge indices
+ * @param maxRecorded Number of conflicts to record
+ * @param limit Number of conflicts after which the scan stops
+ * @return Number of conflicts found, at most limit
+ */
+static size_t KERNEL_NAME(evaluate)(const kernel_t *kernel, uint32_t *conflicts, size_t maxRecorded, size_t limit) {
+    const KERNEL_INDEX_T *edges = kernel -> edges;
+    const uint8_t *packed = kernel -> packedColors;
+    size_t numEdges = kernel -> numEdges;
+    size_t found = 0;
+
+    for(size_t i = 0; i < numEdges; ++i) {
+        KERNEL_INDEX_T u = edges[2 * i];
+        KERNEL_INDEX_T v = edges[2 * i + 1];
+        if(KERNEL_COLOR(packed, u) == KERNEL_COLOR(packed, v)) {
+            if(found < maxRecorded) {
+                conflicts[found] = (uint32_t) i;
+            }
+            if(++found >= limit) {
+                break;
+            }
+        }
+    }
+
+    return found;
+}
+
+/**
+ * @brief Sums the weights of the monochromatic edges and records the first maxRecorded of them, stopping as soon as
+ *        the weight reaches limit
+ * 
+ * @param kernel The kernel with the coloring to evaluate and edge weights attached
+ * @param conflicts Output buffer for at least maxRecorded edge indices
+ * @param maxRecorded Number of conflicts to record
+ * @param limit Weight after which the scan stops
+ * @param count Set to the number of conflicts found
+ * @return Weight of the conflicts found, the first weight of at least limit if the scan stopped early
+ */
+static size_t KERNEL_NAME(evaluateWeighted)(const kernel_t *kernel, uint32_t *conflicts, size_t maxRecorded, size_t limit, size_t *count) {
+    const KERNEL_INDEX_T *edges = kernel -> edges;
+    const uint8_t *packed = kernel -> packedColors;
+    const uint8_t *weights = kernel -> edgeWeights;
+    size_t numEdges = kernel -> numEdges;
+    size_t found = 0;
+    size_t weight = 0;
+
+    for(size_t i = 0; i < numEdges; ++i) {
+        KERNEL_INDEX_T u = edges[2 * i];
+        KERNEL_INDEX_T v = edges[2 * i + 1];
+        if(KERNEL_COLOR(packed, u) == KERNEL_COLOR(packed, v)) {
+            if(found < maxRecorded) {
+                conflicts[found] = (uint32_t) i;
+            }
+            ++found;
+            if((weight += weights[i]) >= limit) {
+                break;
+            }
+        }
+    }
+
+    *count = found;
+    return weight;
+}
+
+/**
+ * @brief Collects every conflicting edge of the current coloring into the conflict list, sets the cost and the weight
+ *        and copies the first conflicts into the sample. Needs the adjacency attached
+ * 
+ * @param kernel The kernel
+ */
+static void KERNEL_NAME(collectConflicts)(kernel_t *kernel) {
+    const KERNEL_INDEX_T *edges = kernel -> edges;
+    const uint8_t *packed = kernel -> packedColors;
+    const uint8_t *weights = kernel -> edgeWeights;
+    size_t numEdges = kernel -> numEdges;
+    size_t found = 0;
+    size_t weight = 0;
+
+    for(size_t i = 0; i < numEdges; ++i) {
+        if(KERNEL_COLOR(packed, edges[2 * i]) == KERNEL_COLOR(packed, edges[2 * i + 1])) {
+            kernel -> conflictPosition[i] = (uint32_t) found;
+            kernel -> conflictList[found++] = (uint32_t) i;
+            weight += weights != NULL ? weights[i] : 0;
+        }
+    }
+
+    kernel -> currentCost = found;
+    kernel -> currentWeight = weight;
+    memcpy(kernel -> conflictSample, kernel -> conflictList, sizeof(uint32_t) * (found < KERNEL_CONFLICT_SAMPLE ? found : KERNEL_CONFLICT_SAMPLE));
+}
+
+/**
+ * @brief Prices the recoloring of node from oldColor to the color it already has over its own edges and keeps it if
+ *        the cost, or the weight if edge weights are attached, does not grow. Needs the adjacency attached
+ * 
+ * @param kernel The kernel with node recolored
+ * @param node The recolored node
+ * @param oldColor The color of node before
+ * @return -1 if the recoloring was rejected and has to be undone, 1 if it improved the coloring, 0 otherwise
+ */
+static int KERNEL_NAME(moveNode)(kernel_t *kernel, size_t node, int oldColor) {
+    const graph_adjacency_t *adjacency = kernel -> adjacency;
+    const uint8_t *packed = kernel -> packedColors;
+    const uint8_t *weights = kernel -> edgeWeights;
+    int newColor = KERNEL_COLOR(packed, node);
+    long costChange = 0;
+    long weightChange = 0;
+
+    for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+        int color = KERNEL_COLOR(packed, adjacency -> neighbors[i]);
+        if(color == oldColor) {
+            --costChange;
+            weightChange -= weights != NULL ? weights[adjacency -> edgeIds[i]] : 0;
+        } else if(color == newColor) {
+            ++costChange;
+            weightChange += weights != NULL ? weights[adjacency -> edgeIds[i]] : 0;
+        }
+    }
+    if(weights != NULL ? weightChange > 0 : costChange > 0) {
+        return -1;
+    }
+
+    // Only the edges of the node can change between conflicting and not
+    for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+        int color = KERNEL_COLOR(packed, adjacency -> neighbors[i]);
+        if(color == oldColor) {
+            removeConflict(kernel, adjacency -> edgeIds[i]);
+        } else if(color == newColor) {
+            addConflict(kernel, adjacency -> edgeIds[i]);
+        }
+    }
+    kernel -> currentWeight = (size_t) ((long) kernel -> currentWeight + weightChange);
+    return (weights != NULL ? weightChange < 0 : costChange < 0) ? 1 : 0;
+}
+
+/**
+ * @brief Runs the search of the kernel until it reaches a coloring with less than maxConflicts conflicts that is
+ *        new (a restart) or better than the coloring before, or until the iterations are used up
+ * 
+ * @param kernel The kernel, holds the current coloring afterwards
+ * @param rng The random stream
+ * @param conflicts Output buffer for at least maxConflicts edge indices
+ * @param maxConflicts Number of conflicts from which on a coloring is unusable, at most KERNEL_CONFLICT_SAMPLE
+ * @param maxIterations Number of search steps to do at most
+ * @return Number of conflicts of the found coloring, maxConflicts if none was found
+ */
+static size_t KERNEL_NAME(search)(kernel_t *kernel, rng_state_t *rng, uint32_t *conflicts, size_t maxConflicts, long maxIterations) {
+    const KERNEL_INDEX_T *edges = kernel -> edges;
+
+    for(long iteration = 0; iteration < maxIterations; ++iteration) {
+        if(kernel -> restartInterval == 0 || kernel -> currentCost == KERNEL_NO_COST || kernel -> stepsSinceImprovement >= kernel -> restartInterval) {
+            if(kernel -> construct != NULL) {
+                kernel -> construct(kernel -> constructContext, kernel, rng);
+            } else {
+                KERNEL_NAME(randomize)(kernel, rng);
+            }
+            // Independent sampling only has to know whether the coloring is usable
+            if(kernel -> restartInterval == 0) {
+                kernel -> currentCost = KERNEL_NAME(evaluate)(kernel, kernel -> conflictSample, KERNEL_CONFLICT_SAMPLE, maxConflicts);
+            } else if(kernel -> adjacency != NULL) {
+                KERNEL_NAME(collectConflicts)(kernel);
+            } else if(kernel -> edgeWeights != NULL) {
+                kernel -> currentWeight = KERNEL_NAME(evaluateWeighted)(kernel, kernel -> conflictSample, KERNEL_CONFLICT_SAMPLE, SIZE_MAX, &kernel -> currentCost);
+            } else {
+                kernel -> currentCost = KERNEL_NAME(evaluate)(kernel, kernel -> conflictSample, KERNEL_CONFLICT_SAMPLE, kernel -> numEdges + 1);
+            }
+            kernel -> stepsSinceImprovement = 0;
+            if(filterActive(kernel)) {
+                computeColorHashes(kernel);
+            }
+        } else {
+            // Recolor one node, preferably an endpoint of a conflicting edge
+            const uint32_t *known = kernel -> adjacency != NULL ? kernel -> conflictList : kernel -> conflictSample;
+            size_t sampled = kernel -> adjacency != NULL || kernel -> currentCost < KERNEL_CONFLICT_SAMPLE ? kernel -> currentCost : KERNEL_CONFLICT_SAMPLE;
+            size_t node;
+            if(sampled > 0 && (int) rngBelow(rng, 100) < kernel -> samplingBias) {
+                uint32_t edge = known[rngBelow(rng, (uint32_t) sampled)];
+                node = edges[2 * edge + rngBelow(rng, 2)];
+            } else {
+                node = rngBelow(rng, (uint32_t) kernel -> numNodes);
+            }
+            int oldColor = KERNEL_COLOR(kernel -> packedColors, node);
+            int newColor = (oldColor + 1 + (int) rngBelow(rng, KERNEL_COLORS - 1)) % KERNEL_COLORS;
+            kernelSetColor(kernel, node, newColor);
+
+            // A coloring some generator already reported is not worth the edge scan
+            bool filtered = filterActive(kernel);
+            if(filtered) {
+                moveColorHash(kernel, node, oldColor, newColor);
+                if(filterContains(kernel -> filter, currentColoringKey(kernel))) {
+                    kernelSetColor(kernel, node, oldColor);
+                    moveColorHash(kernel, node, newColor, oldColor);
+                    ++kernel -> filterSkips;
+                    ++kernel -> stepsSinceImprovement;
+                    continue;
+                }
+            }
+
+            // With the adjacency the change is priced over the edges of the node alone
+            if(kernel -> adjacency != NULL) {
+                int moved = KERNEL_NAME(moveNode)(kernel, node, oldColor);
+                if(moved == -1) {
+                    kernelSetColor(kernel, node, oldColor);
+                    if(filtered) {
+                        moveColorHash(kernel, node, newColor, oldColor);
+                    }
+                }
+                if(moved != 1) {
+                    ++kernel -> stepsSinceImprovement;
+                    continue;
+                }
+                kernel -> stepsSinceImprovement = 0;
+                if(kernel -> currentCost < maxConflicts) {
+                    size_t cost = kernel -> currentCost;
+                    memcpy(kernel -> conflictSample, kernel -> conflictList, sizeof(uint32_t) * (cost < KERNEL_CONFLICT_SAMPLE ? cost : KERNEL_CONFLICT_SAMPLE));
+                    memcpy(conflicts, kernel -> conflictSample, sizeof(uint32_t) * cost);
+                    return cost;
+                }
+                continue;
+            }
+
+            // A candidate with more conflicts than the current coloring is rejected as soon as that is certain.
+            // With edge weights the walk compares the weights of the conflicts instead of their number
+            size_t cost;
+            size_t weight = 0;
+            bool rejected;
+            if(kernel -> edgeWeights != NULL) {
+                weight = KERNEL_NAME(evaluateWeighted)(kernel, kernel -> candidateSample, KERNEL_CONFLICT_SAMPLE, kernel -> currentWeight + 1, &cost);
+                rejected = weight > kernel -> currentWeight;
+            } else {
+                cost = KERNEL_NAME(evaluate)(kernel, kernel -> candidateSample, KERNEL_CONFLICT_SAMPLE, kernel -> currentCost + 1);
+                rejected = cost > kernel -> currentCost;
+            }
+            if(rejected) {
+                kernelSetColor(kernel, node, oldColor);
+                if(filtered) {
+                    moveColorHash(kernel, node, newColor, oldColor);
+                }
+                ++kernel -> stepsSinceImprovement;
+                continue;
+            }
+
+            bool improved = kernel -> edgeWeights != NULL ? weight < kernel -> currentWeight : cost < kernel -> currentCost;
+            memcpy(kernel -> conflictSample, kernel -> candidateSample, sizeof(uint32_t) * (cost < KERNEL_CONFLICT_SAMPLE ? cost : KERNEL_CONFLICT_SAMPLE));
+            kernel -> currentCost = cost;
+            kernel -> currentWeight = weight;
+            if(!improved) {
+                ++kernel -> stepsSinceImprovement;
+                continue;
+            }
+            kernel -> stepsSinceImprovement = 0;
+        }
+
+        if(kernel -> currentCost < maxConflicts) {
+            memcpy(conflicts, kernel -> conflictSample, sizeof(uint32_t) * kernel -> currentCost);
+            return kernel -> currentCost;
+        }
+    }
+
+    return maxConflicts;
+}
+
+#undef KERNEL_CONCAT_INNER
+#undef KERNEL_CONCAT
+#undef KERNEL_NAME
+#undef KERNEL_COLOR
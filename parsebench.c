@@ -0,0 +1,139 @@
+/**
+ * @file parsebench.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Main-file of the graph file parser benchmark
+ * @details Loads a graph file with graphLoadFile, the same path the generators take with -f, several times and
+ *          prints the fastest and the slowest load with the throughput of the fastest one. The file is read once
+ *          before the first measured load so every run finds it in the page cache.
+ *          make benchparse writes a DIMACS file of 10M edges over 2M nodes and runs the benchmark on it.
+ *
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <getopt.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+
+/**
+ * Program name
+ * @brief Pointer to the program name string
+ */
+static const char *PROGRAM_NAME;
+
+/**
+ * @brief Writes a given formatted message to stderr and exits with EXIT_FAILURE
+ *
+ * @param output Formatted output string
+ * @param ... Fomat elements
+ */
+static void printStderrAndExit(const char *output, ...) {
+    va_list args;
+    va_start(args, output);
+    vfprintf(stderr, output, args);
+    va_end(args);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Writes usage information to stderr and exits with EXIT_FAILURE
+ * @details global variables: PROGRAM_NAME
+ */
+static void printUsageAndExit(void) {
+    printStderrAndExit("Usage: %s [-r repeats] graphfile\n", PROGRAM_NAME);
+}
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in seconds
+ */
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Loads the graph file once and returns how long it took
+ * @details global variables: PROGRAM_NAME
+ *
+ * @param path Path of the graph file
+ * @param numNodes Output for the number of nodes of the loaded graph
+ * @param numEdges Output for the number of edges of the loaded graph
+ */
+static double loadOnce(const char *path, size_t *numNodes, size_t *numEdges) {
+    graph_t graph;
+    char error[GRAPH_ERROR_SIZE];
+    double start = now();
+    if(graphLoadFile(&graph, path, error) == -1) {
+        printStderrAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, error);
+    }
+    double seconds = now() - start;
+    *numNodes = graph.numNodes;
+    *numEdges = graph.numEdges;
+    graphFree(&graph);
+    return seconds;
+}
+
+/**
+ * @brief Program entry point
+ * @details global variables: PROGRAM_NAME
+ *
+ * @param argc The argument counter
+ * @param argv The argument vector
+ * @return Returns EXIT_SUCCESS on program success
+ */
+int main(int argc, char **argv) {
+    PROGRAM_NAME = argv[0];
+
+    long repeats = 5;
+    int option;
+    while((option = getopt(argc, argv, "r:")) != -1) {
+        if(option != 'r') {
+            printUsageAndExit();
+        }
+        char *end;
+        errno = 0;
+        repeats = strtol(optarg, &end, 10);
+        if(errno != 0 || *end != '\0' || repeats < 1) {
+            printStderrAndExit("[%s] ERROR: The number of repeats has to be a positive integer\n", PROGRAM_NAME);
+        }
+    }
+    if(optind != argc - 1) {
+        printUsageAndExit();
+    }
+    const char *path = argv[optind];
+
+    struct stat fileStat;
+    if(stat(path, &fileStat) == -1) {
+        printStderrAndExit("[%s] ERROR: Failed to stat %s: %s\n", PROGRAM_NAME, path, strerror(errno));
+    }
+
+    size_t numNodes;
+    size_t numEdges;
+    loadOnce(path, &numNodes, &numEdges);
+
+    double fastest = 0;
+    double slowest = 0;
+    for(long i = 0; i < repeats; ++i) {
+        double seconds = loadOnce(path, &numNodes, &numEdges);
+        if(i == 0 || seconds < fastest) {
+            fastest = seconds;
+        }
+        if(seconds > slowest) {
+            slowest = seconds;
+        }
+    }
+
+    printf("%s: %zu nodes, %zu edges, %.1f MB\n", path, numNodes, numEdges, fileStat.st_size / 1e6);
+    printf("fastest %.3f s, slowest %.3f s over %ld loads, %.1f MB/s, %.1f M edges/s\n", fastest, slowest, repeats,
+        fileStat.st_size / 1e6 / fastest, numEdges / 1e6 / fastest);
+    return EXIT_SUCCESS;
+}
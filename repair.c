@@ -0,0 +1,146 @@
+/**
+ * @file repair.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Kempe chain repair of nearly proper colorings
+ *
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "repair.h"
+
+int repairCreate(repair_t *repair, const graph_adjacency_t *adjacency) {
+    memset(repair, 0, sizeof(*repair));
+    repair -> adjacency = adjacency;
+    repair -> visited = calloc(adjacency -> numNodes > 0 ? adjacency -> numNodes : 1, sizeof(uint32_t));
+    repair -> chain = malloc(sizeof(uint32_t) * REPAIR_MAX_CHAIN);
+    if(repair -> visited == NULL || repair -> chain == NULL) {
+        repairFree(repair);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Starts a new search by advancing the epoch, clearing the visited marks only when the epoch wraps around
+ */
+static uint32_t nextEpoch(repair_t *repair) {
+    if(++repair -> epoch == 0) {
+        memset(repair -> visited, 0, sizeof(uint32_t) * repair -> adjacency -> numNodes);
+        repair -> epoch = 1;
+    }
+    return repair -> epoch;
+}
+
+/**
+ * @brief Collects the Kempe chain of start for the colors first and second with a breadth first search
+ *
+ * @param repair The repair state, holds the chain in chain and its nodes marked with the current epoch afterwards
+ * @param kernel The kernel with the coloring
+ * @param start The node the chain starts at, has color first
+ * @param first The color of start
+ * @param second The other color of the chain
+ * @return Number of nodes of the chain or 0 if it has more than REPAIR_MAX_CHAIN nodes
+ */
+static size_t collectChain(repair_t *repair, const kernel_t *kernel, uint32_t start, int first, int second) {
+    const graph_adjacency_t *adjacency = repair -> adjacency;
+    uint32_t epoch = nextEpoch(repair);
+    size_t size = 1;
+    repair -> chain[0] = start;
+    repair -> visited[start] = epoch;
+
+    // The chain array doubles as the queue of the search
+    for(size_t head = 0; head < size; ++head) {
+        uint32_t node = repair -> chain[head];
+        int other = kernelGetColor(kernel, node) == first ? second : first;
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            uint32_t neighbor = adjacency -> neighbors[i];
+            if(repair -> visited[neighbor] == epoch || kernelGetColor(kernel, neighbor) != other) {
+                continue;
+            }
+            if(size == REPAIR_MAX_CHAIN) {
+                return 0;
+            }
+            repair -> visited[neighbor] = epoch;
+            repair -> chain[size++] = neighbor;
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief Counts the conflicts a swap of the collected chain resolves, the conflicts between chain nodes and other nodes
+ */
+static size_t chainGain(const repair_t *repair, const kernel_t *kernel, size_t size) {
+    const graph_adjacency_t *adjacency = repair -> adjacency;
+    size_t gain = 0;
+    for(size_t i = 0; i < size; ++i) {
+        uint32_t node = repair -> chain[i];
+        int color = kernelGetColor(kernel, node);
+        for(uint32_t n = adjacency -> offsets[node]; n < adjacency -> offsets[node + 1]; ++n) {
+            uint32_t neighbor = adjacency -> neighbors[n];
+            if(repair -> visited[neighbor] != repair -> epoch && kernelGetColor(kernel, neighbor) == color) {
+                ++gain;
+            }
+        }
+    }
+    return gain;
+}
+
+/**
+ * @brief Tries every other color for the Kempe chains of both endpoints of a conflicting edge and swaps the first one that resolves it
+ *
+ * @return true if a chain was swapped
+ */
+static bool repairEdge(repair_t *repair, kernel_t *kernel, uint32_t u, uint32_t v) {
+    int color = kernelGetColor(kernel, u);
+    if(kernelGetColor(kernel, v) != color) {
+        // An earlier swap already resolved it
+        return false;
+    }
+
+    for(int end = 0; end < 2; ++end) {
+        uint32_t start = end == 0 ? u : v;
+        uint32_t other = end == 0 ? v : u;
+        for(int swapColor = 0; swapColor < kernel -> numColors; ++swapColor) {
+            if(swapColor == color) {
+                continue;
+            }
+            size_t size = collectChain(repair, kernel, start, color, swapColor);
+            if(size == 0 || repair -> visited[other] == repair -> epoch || chainGain(repair, kernel, size) == 0) {
+                continue;
+            }
+            for(size_t i = 0; i < size; ++i) {
+                uint32_t node = repair -> chain[i];
+                kernelSetColor(kernel, node, kernelGetColor(kernel, node) == color ? swapColor : color);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t repairColoring(repair_t *repair, kernel_t *kernel, const graph_t *graph, const uint32_t *conflicts, size_t numConflicts) {
+    bool swapped = false;
+    for(size_t i = 0; i < numConflicts; ++i) {
+        if(repairEdge(repair, kernel, graph -> edges[conflicts[i]][0], graph -> edges[conflicts[i]][1])) {
+            swapped = true;
+        }
+    }
+
+    if(swapped) {
+        kernelRefreshConflicts(kernel);
+    }
+    return swapped ? kernel -> currentCost : numConflicts;
+}
+
+void repairFree(repair_t *repair) {
+    free(repair -> visited);
+    free(repair -> chain);
+    memset(repair, 0, sizeof(*repair));
+}
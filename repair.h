@@ -0,0 +1,71 @@
+/**
+ * @file repair.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the Kempe chain repair of nearly proper colorings
+ * @details For a conflicting edge (u, v) of color c and another color d, the Kempe chain of u is every node reachable
+ *          from u over edges between a c and a d colored node. Swapping c and d on the chain keeps every edge inside
+ *          the chain and to the other colors as it was, and resolves every conflict between a chain node and a node
+ *          outside of it, since such a neighbor would otherwise belong to the chain. So a swap never adds conflicts
+ *          and resolves (u, v) whenever v is not on the chain.
+ *
+ **/
+
+#ifndef REPAIR_H_FILE
+#define REPAIR_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "graph.h"
+#include "kernel.h"
+
+/**
+ * @brief Chains with more nodes are not swapped, the walk of the kernel is cheaper than a swap of that size
+ */
+#define REPAIR_MAX_CHAIN 4096
+
+/**
+ * @brief Buffers of the chain search over the adjacency of a graph.
+ *        The visited array holds the epoch of the last search that reached a node, so it never has to be cleared
+ *
+ */
+typedef struct {
+    const graph_adjacency_t *adjacency;
+    uint32_t *visited;
+    uint32_t epoch;
+    uint32_t *chain;
+} repair_t;
+
+/**
+ * @brief Allocates the buffers of the chain search
+ *
+ * @param repair The repair state to initialise
+ * @param adjacency The adjacency of the graph, has to outlive the repair state
+ * @return 0 on success, -1 with errno set on failure
+ */
+int repairCreate(repair_t *repair, const graph_adjacency_t *adjacency);
+
+/**
+ * @brief Swaps Kempe chains for the given conflicts of the current coloring of the kernel wherever that reduces the
+ *        number of conflicts, then recomputes the conflicts of the kernel
+ *
+ * @param repair The repair state built for the adjacency of graph
+ * @param kernel The kernel with the coloring to repair
+ * @param graph The graph of the kernel, edge indices of both are the same
+ * @param conflicts Indices of conflicting edges
+ * @param numConflicts Number of conflicts
+ * @return Number of conflicts of the repaired coloring, which the kernel holds in its conflict sample
+ */
+size_t repairColoring(repair_t *repair, kernel_t *kernel, const graph_t *graph, const uint32_t *conflicts, size_t numConflicts);
+
+/**
+ * @brief Frees the memory of the repair state
+ *
+ * @param repair The repair state to free
+ */
+void repairFree(repair_t *repair);
+
+#endif
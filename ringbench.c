@@ -0,0 +1,532 @@
+/**
+ * @file ringbench.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Main-file of the ring buffer microbenchmark
+ * @details Drives a shared memory ring between forked producer processes and one consumer without any graph work.
+ *          Every implementation is measured with the same message count, slot size and capacity:
+ *            sem3         the protocol of the supervisor and the generators, a writer mutex semaphore, a free slot
+ *                         semaphore and a filled slot semaphore
+ *            spin         a bounded ring with a sequence number per slot (Vyukov), producers claim slots with a CAS,
+ *                         everybody waits with sched_yield
+ *            spin-sem     the same ring, but the consumer sleeps on a semaphore that every producer posts
+ *          Producers stamp every message with CLOCK_MONOTONIC_RAW, the consumer computes the handoff latency.
+ *          Context switches are taken from getrusage for the consumer and the producers separately.
+ *
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <limits.h>
+#include <getopt.h>
+#include <sched.h>
+#include <time.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "commons.h"
+
+#define NUM_IMPLEMENTATIONS 3
+
+/**
+ * Benchmark parameters struct
+ * @brief Stores all parameters passed to the program
+ */
+typedef struct {
+    long producers;
+    long capacity;
+    long slotBytes;
+    long messages;
+    long implementation;
+} bench_parameters_t;
+
+/**
+ * @brief Shared state of the ring, followed by the slots
+ */
+typedef struct {
+    uint64_t writePos CACHE_ALIGNED;
+    uint64_t readPos CACHE_ALIGNED;
+    int start CACHE_ALIGNED;
+    sem_t rSem;
+    sem_t wSem;
+    sem_t wSyncSem;
+} ring_control_t;
+
+/**
+ * @brief Header of a slot, followed by the payload
+ */
+typedef struct {
+    uint64_t sequence;
+    uint64_t timestamp;
+    int64_t producer;
+} slot_header_t;
+
+/**
+ * @brief Result of one benchmark run
+ */
+typedef struct {
+    double seconds;
+    uint64_t messages;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    long consumerSwitches;
+    long consumerInvoluntarySwitches;
+    long producerSwitches;
+    long producerInvoluntarySwitches;
+    uint64_t checksum;
+} bench_result_t;
+
+static const char *IMPLEMENTATION_NAMES[NUM_IMPLEMENTATIONS] = {
+    "sem3",
+    "spin",
+    "spin-sem",
+};
+
+/**
+ * Program name
+ * @brief Pointer to the program name string
+ */
+static const char *PROGRAM_NAME;
+
+/**
+ * @brief The mapped ring, NULL if not mapped
+ */
+static ring_control_t *ring = NULL;
+
+/**
+ * @brief Size of the mapping of ring
+ */
+static size_t ringSize = 0;
+
+/**
+ * @brief Distance between two slots, the slot size rounded up to a cache line
+ */
+static size_t slotStride = 0;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Util
+
+/**
+ * @brief Unmaps the ring
+ * @details global variables: ring, ringSize
+ */
+static void cleanup(void) {
+    if(ring != NULL) {
+        munmap(ring, ringSize);
+        ring = NULL;
+    }
+}
+
+/**
+ * @brief Writes a given formatted message to stderr, cleans up and exits with EXIT_FAILURE
+ *
+ * @param output Formatted output string
+ * @param ... Fomat elements
+ */
+static void printStderrCleaupAndExit(const char *output, ...) {
+    va_list args;
+    va_start(args, output);
+    vfprintf(stderr, output, args);
+    va_end(args);
+    cleanup();
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Writes usage information to stderr and exits with EXIT_FAILURE
+ * @details global variables: PROGRAM_NAME
+ */
+static void printUsageAndExit(void) {
+    printStderrCleaupAndExit("Usage: %s [-p producers] [-c capacity] [-s slotbytes] [-m messages] [-i sem3|spin|spin-sem]\n"
+        "Defaults: 1 producer, capacity %d, %zu byte slots, 200000 messages per producer, all implementations\n",
+        PROGRAM_NAME, MAX_NUM_RESULT_SETS, sizeof(result_set_t));
+}
+
+/**
+ * @brief Returns the current CLOCK_MONOTONIC_RAW time in nanoseconds
+ */
+static uint64_t now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &time);
+    return (uint64_t) time.tv_sec * 1000000000ULL + (uint64_t) time.tv_nsec;
+}
+
+/**
+ * @brief Returns the slot with the given index
+ * @details global variables: ring, slotStride
+ */
+static slot_header_t* slotAt(uint64_t index) {
+    return (slot_header_t*) ((uint8_t*) ring + sizeof(ring_control_t) + index * slotStride);
+}
+
+/**
+ * @brief Compares two latencies for qsort
+ */
+static int compareLatencies(const void *a, const void *b) {
+    uint64_t left = *(const uint64_t*) a;
+    uint64_t right = *(const uint64_t*) b;
+    return left < right ? -1 : left > right;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Argument parsing
+
+/**
+ * @brief Parses a positive number of an option, prints an error and exits if it is not one
+ * @details global variables: PROGRAM_NAME
+ *
+ * @param value The option argument
+ * @param name Name of the option for the error message
+ * @return The parsed number
+ */
+static long parsePositive(const char *value, const char *name) {
+    char *endptr;
+    errno = 0;
+    long result = strtol(value, &endptr, 10);
+    if(endptr == value || *endptr != '\0' || errno == ERANGE || result < 1) {
+        fprintf(stderr, "[%s] ERROR: %s has to be a positive number!\n", PROGRAM_NAME, name);
+        printUsageAndExit();
+    }
+    return result;
+}
+
+/**
+ * Parse arguments function
+ *
+ * @brief This function parses the arguments given to the program via argc and argv. If something is not right it prints an eror message and exits with EXIT_FAILURE
+ * @details global variables: PROGRAM_NAME
+ *
+ * @param argc The argument counter
+ * @param argv The argument vector
+ * @return The parsed parameters, implementation is -1 to run all of them
+ */
+static bench_parameters_t parseArguments(int argc, char **argv) {
+    bench_parameters_t parameters = {
+        1,
+        MAX_NUM_RESULT_SETS,
+        sizeof(result_set_t),
+        200000,
+        -1,
+    };
+    int option;
+    while ((option = getopt(argc, argv, ":p:c:s:m:i:")) != -1) {
+        switch (option) {
+            case 'p':
+                parameters.producers = parsePositive(optarg, "Producers");
+                break;
+            case 'c':
+                parameters.capacity = parsePositive(optarg, "Capacity");
+                break;
+            case 's':
+                parameters.slotBytes = parsePositive(optarg, "Slot size");
+                break;
+            case 'm':
+                parameters.messages = parsePositive(optarg, "Messages");
+                break;
+            case 'i':
+                parameters.implementation = -1;
+                for(int i = 0; i < NUM_IMPLEMENTATIONS; ++i) {
+                    if(strcmp(optarg, IMPLEMENTATION_NAMES[i]) == 0) {
+                        parameters.implementation = i;
+                    }
+                }
+                if(parameters.implementation == -1) {
+                    fprintf(stderr, "[%s] ERROR: Unknown implementation: %s\n", PROGRAM_NAME, optarg);
+                    printUsageAndExit();
+                }
+                break;
+            case ':':
+                fprintf(stderr, "[%s] ERROR: Option -%c requires a value!\n", PROGRAM_NAME, optopt);
+                printUsageAndExit();
+                break;
+            case '?':
+            default:
+                fprintf(stderr, "[%s] ERROR: Unknown option: -%c\n", PROGRAM_NAME, optopt);
+                printUsageAndExit();
+                break;
+        }
+    }
+
+    if ((argc - optind) > 0) {
+        fprintf(stderr, "[%s] ERROR: Too many arguments were passed!\n", PROGRAM_NAME);
+        printUsageAndExit();
+    }
+    return parameters;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Ring
+
+/**
+ * @brief Maps the ring into shared anonymous memory so forked producers share it
+ * @details global variables: PROGRAM_NAME, ring, ringSize, slotStride
+ */
+static void openRing(bench_parameters_t parameters) {
+    slotStride = (sizeof(slot_header_t) + parameters.slotBytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    ringSize = sizeof(ring_control_t) + parameters.capacity * slotStride;
+    ring = mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(ring == MAP_FAILED) {
+        ring = NULL;
+        printStderrCleaupAndExit("[%s] ERROR: Failed to map ring: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+}
+
+/**
+ * @brief Resets the ring for a new run
+ * @details global variables: PROGRAM_NAME, ring
+ */
+static void resetRing(bench_parameters_t parameters) {
+    memset(ring, 0, ringSize);
+    for(long i = 0; i < parameters.capacity; ++i) {
+        slotAt(i) -> sequence = i;
+    }
+    if(sem_init(&ring -> rSem, 1, 0) == -1 || sem_init(&ring -> wSem, 1, parameters.capacity) == -1 || sem_init(&ring -> wSyncSem, 1, 1) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to initialise semaphores: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+}
+
+/**
+ * @brief Destroys the semaphores of a run
+ * @details global variables: ring
+ */
+static void destroyRing(void) {
+    sem_destroy(&ring -> rSem);
+    sem_destroy(&ring -> wSem);
+    sem_destroy(&ring -> wSyncSem);
+}
+
+/**
+ * @brief Waits for a semaphore, retrying on EINTR
+ */
+static void waitSemaphore(sem_t *semaphore) {
+    while(sem_wait(semaphore) == -1) {
+        if(errno != EINTR) {
+            printStderrCleaupAndExit("[%s] ERROR: There was an error waiting the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+        }
+    }
+}
+
+/**
+ * @brief Fills the payload of a slot and stamps it
+ */
+static void fillSlot(slot_header_t *slot, long producer, long message, long slotBytes) {
+    memset((uint8_t*) (slot + 1), (int) (message & 0xFF), slotBytes);
+    slot -> producer = producer;
+    slot -> timestamp = now();
+}
+
+/**
+ * @brief Reads the payload of a slot like the supervisor reads a result set
+ *
+ * @return A checksum so the reads are not optimised away
+ */
+static uint64_t readSlot(const slot_header_t *slot, long slotBytes) {
+    const uint8_t *payload = (const uint8_t*) (slot + 1);
+    uint64_t checksum = 0;
+    for(long i = 0; i < slotBytes; i += sizeof(long)) {
+        checksum += payload[i];
+    }
+    return checksum + slot -> producer;
+}
+
+/**
+ * @brief Claims the next slot of the sequence ring as a producer, yielding while the ring is full
+ * @details global variables: ring
+ *
+ * @param capacity Number of slots
+ * @return The claimed position
+ */
+static uint64_t claimSequenceSlot(long capacity) {
+    uint64_t position = __atomic_load_n(&ring -> writePos, __ATOMIC_RELAXED);
+    while(true) {
+        slot_header_t *slot = slotAt(position % capacity);
+        int64_t difference = (int64_t) __atomic_load_n(&slot -> sequence, __ATOMIC_ACQUIRE) - (int64_t) position;
+        if(difference == 0) {
+            if(__atomic_compare_exchange_n(&ring -> writePos, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                return position;
+            }
+        } else if(difference < 0) {
+            // The consumer did not free the slot yet
+            sched_yield();
+            position = __atomic_load_n(&ring -> writePos, __ATOMIC_RELAXED);
+        } else {
+            position = __atomic_load_n(&ring -> writePos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * @brief Producer process, writes its messages with the given implementation and exits
+ * @details global variables: ring
+ */
+static void runProducer(bench_parameters_t parameters, int implementation, long producer) {
+    while(!__atomic_load_n(&ring -> start, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+
+    for(long message = 0; message < parameters.messages; ++message) {
+        if(implementation == 0) {
+            waitSemaphore(&ring -> wSyncSem);
+            waitSemaphore(&ring -> wSem);
+            fillSlot(slotAt(ring -> writePos), producer, message, parameters.slotBytes);
+            ring -> writePos = (ring -> writePos + 1) % parameters.capacity;
+            sem_post(&ring -> rSem);
+            sem_post(&ring -> wSyncSem);
+            continue;
+        }
+
+        uint64_t position = claimSequenceSlot(parameters.capacity);
+        slot_header_t *slot = slotAt(position % parameters.capacity);
+        fillSlot(slot, producer, message, parameters.slotBytes);
+        __atomic_store_n(&slot -> sequence, position + 1, __ATOMIC_RELEASE);
+        if(implementation == 2) {
+            sem_post(&ring -> rSem);
+        }
+    }
+
+    exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Consumer side, reads all messages and records their latencies
+ * @details global variables: ring
+ *
+ * @param latencies Buffer for one latency per message
+ * @return Checksum of all read payloads
+ */
+static uint64_t runConsumer(bench_parameters_t parameters, int implementation, uint64_t *latencies, uint64_t total) {
+    uint64_t checksum = 0;
+    for(uint64_t message = 0; message < total; ++message) {
+        slot_header_t *slot;
+        if(implementation == 0) {
+            waitSemaphore(&ring -> rSem);
+            slot = slotAt(ring -> readPos);
+            checksum += readSlot(slot, parameters.slotBytes);
+            latencies[message] = now() - slot -> timestamp;
+            ring -> readPos = (ring -> readPos + 1) % parameters.capacity;
+            sem_post(&ring -> wSem);
+            continue;
+        }
+
+        if(implementation == 2) {
+            waitSemaphore(&ring -> rSem);
+        }
+        // A post only means some slot was published, the next one may still be written by a slower producer
+        slot = slotAt(message % parameters.capacity);
+        while(__atomic_load_n(&slot -> sequence, __ATOMIC_ACQUIRE) != message + 1) {
+            sched_yield();
+        }
+        checksum += readSlot(slot, parameters.slotBytes);
+        latencies[message] = now() - slot -> timestamp;
+        __atomic_store_n(&slot -> sequence, message + parameters.capacity, __ATOMIC_RELEASE);
+    }
+    return checksum;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Benchmark
+
+/**
+ * @brief Runs one implementation and measures it
+ * @details global variables: PROGRAM_NAME, ring
+ */
+static bench_result_t runBenchmark(bench_parameters_t parameters, int implementation) {
+    bench_result_t result;
+    memset(&result, 0, sizeof(result));
+    result.messages = (uint64_t) parameters.producers * parameters.messages;
+
+    uint64_t *latencies = malloc(sizeof(uint64_t) * result.messages);
+    if(latencies == NULL) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to allocate latencies: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+    resetRing(parameters);
+
+    struct rusage consumerBefore, consumerAfter, producersBefore, producersAfter;
+    getrusage(RUSAGE_SELF, &consumerBefore);
+    getrusage(RUSAGE_CHILDREN, &producersBefore);
+
+    // Buffered output would be printed again by every producer
+    fflush(stdout);
+    for(long producer = 0; producer < parameters.producers; ++producer) {
+        pid_t pid = fork();
+        if(pid == -1) {
+            free(latencies);
+            printStderrCleaupAndExit("[%s] ERROR: Failed to fork producer: %s\n", PROGRAM_NAME, strerror(errno));
+        }
+        if(pid == 0) {
+            runProducer(parameters, implementation, producer);
+        }
+    }
+
+    uint64_t start = now();
+    __atomic_store_n(&ring -> start, 1, __ATOMIC_RELEASE);
+    result.checksum = runConsumer(parameters, implementation, latencies, result.messages);
+    result.seconds = (double) (now() - start) / 1e9;
+
+    for(long producer = 0; producer < parameters.producers; ++producer) {
+        int status;
+        if(wait(&status) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            fprintf(stderr, "[%s] WARNING: A producer did not exit cleanly\n", PROGRAM_NAME);
+        }
+    }
+    getrusage(RUSAGE_SELF, &consumerAfter);
+    getrusage(RUSAGE_CHILDREN, &producersAfter);
+    destroyRing();
+
+    qsort(latencies, result.messages, sizeof(uint64_t), compareLatencies);
+    result.p50 = latencies[result.messages * 50 / 100];
+    result.p99 = latencies[result.messages * 99 / 100];
+    result.p999 = latencies[result.messages * 999 / 1000];
+    free(latencies);
+
+    result.consumerSwitches = consumerAfter.ru_nvcsw - consumerBefore.ru_nvcsw;
+    result.consumerInvoluntarySwitches = consumerAfter.ru_nivcsw - consumerBefore.ru_nivcsw;
+    result.producerSwitches = producersAfter.ru_nvcsw - producersBefore.ru_nvcsw;
+    result.producerInvoluntarySwitches = producersAfter.ru_nivcsw - producersBefore.ru_nivcsw;
+    return result;
+}
+
+/**
+ * @brief Program entry point
+ * @details global variables: PROGRAM_NAME
+ *
+ * @param argc The argument counter
+ * @param argv The argument vector
+ * @return Returns EXIT_SUCCESS on program success
+ */
+int main(int argc, char **argv) {
+    PROGRAM_NAME = argv[0];
+    bench_parameters_t parameters = parseArguments(argc, argv);
+    openRing(parameters);
+
+    printf("producers %ld, capacity %ld, slot %ld bytes, %ld messages per producer\n",
+        parameters.producers, parameters.capacity, parameters.slotBytes, parameters.messages);
+    printf("%-10s %12s %10s %10s %10s %22s %22s\n", "ring", "msgs/s", "p50 ns", "p99 ns", "p999 ns",
+        "consumer csw vol/inv", "producer csw vol/inv");
+
+    for(int implementation = 0; implementation < NUM_IMPLEMENTATIONS; ++implementation) {
+        if(parameters.implementation != -1 && parameters.implementation != implementation) {
+            continue;
+        }
+        bench_result_t result = runBenchmark(parameters, implementation);
+        printf("%-10s %12.0f %10llu %10llu %10llu %11ld/%-10ld %11ld/%-10ld\n", IMPLEMENTATION_NAMES[implementation],
+            result.messages / result.seconds, (unsigned long long) result.p50, (unsigned long long) result.p99,
+            (unsigned long long) result.p999, result.consumerSwitches, result.consumerInvoluntarySwitches,
+            result.producerSwitches, result.producerInvoluntarySwitches);
+        fflush(stdout);
+    }
+
+    cleanup();
+    return EXIT_SUCCESS;
+}
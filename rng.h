@@ -0,0 +1,64 @@
+/**
+ * @file rng.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ * 
+ * @brief Small xorshift64* random number generator used by the search kernels instead of rand()
+ *
+ **/
+
+#ifndef RNG_H_FILE
+#define RNG_H_FILE
+
+#include <stdint.h>
+
+/**
+ * @brief State of one random number stream
+ * 
+ */
+typedef struct {
+    uint64_t state;
+} rng_state_t;
+
+/**
+ * @brief Seeds a stream. The seed is scrambled with splitmix64 so that close seeds give unrelated streams
+ * 
+ * @param rng The stream to seed
+ * @param seed Any 64 bit value
+ */
+static inline void rngSeed(rng_state_t *rng, uint64_t seed) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    rng -> state = z != 0 ? z : 0x9E3779B97F4A7C15ULL;
+}
+
+/**
+ * @brief Returns the next 64 random bits of the stream
+ * 
+ * @param rng The stream
+ * @return 64 random bits
+ */
+static inline uint64_t rngNext(rng_state_t *rng) {
+    uint64_t x = rng -> state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng -> state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Returns a random number in [0, bound) using a multiply-shift instead of a modulo
+ * 
+ * @param rng The stream
+ * @param bound Exclusive upper bound, has to be larger than 0
+ * @return A random number smaller than bound
+ */
+static inline uint32_t rngBelow(rng_state_t *rng, uint32_t bound) {
+    return (uint32_t) (((rngNext(rng) >> 32) * bound) >> 32);
+}
+
+#endif
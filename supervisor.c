@@ -25,8 +25,34 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 
 #include "commons.h"
+#include "graph.h"
+#include "weights.h"
+#include "classify.h"
+#include "treedp.h"
+#include "transport.h"
+#include "trace.h"
+
+/**
+ * @brief Number of results after which the supervisor reassigns the strategies of the generators
+ */
+#define PORTFOLIO_EPOCH_RESULTS 32
+
+/**
+ * @brief Weight of the exploration term of the UCB1 policy
+ */
+#define PORTFOLIO_EXPLORATION 0.5
+
+/**
+ * @brief Longest line accepted on the graph update FIFO
+ */
+#define DELTA_LINE_SIZE 256
 
 /**
  * Program parameters struct
@@ -36,8 +62,52 @@ typedef struct {
     long limit;
     long delay;
     bool printGraph;
+    bool hugePages;
+    bool lockMemory;
+    long numColors;
+    long port;
+    const char *graphFile;
+    const char *tracePrefix;
+    const char *deltaFifo;
 } program_parameters_t;
 
+/**
+ * @brief Statistics the portfolio scheduler keeps per strategy
+ */
+typedef struct {
+    double reward;
+    double assignments;
+    long results;
+} strategy_stats_t;
+
+/**
+ * @brief The strategy portfolio. The first entry is plain uniform sampling, the next ones walk from a coloring with
+ *        different restart intervals, biases towards conflicting nodes and random streams.
+ *        The last ones sample greedy constructions or walk from them
+ */
+static const strategy_config_t PORTFOLIO[NUM_STRATEGIES] = {
+    {0, 0, 0, CONSTRUCTION_UNIFORM},
+    {64, 50, 1, CONSTRUCTION_UNIFORM},
+    {256, 80, 2, CONSTRUCTION_UNIFORM},
+    {1024, 90, 3, CONSTRUCTION_UNIFORM},
+    {4096, 95, 4, CONSTRUCTION_UNIFORM},
+    {16384, 100, 5, CONSTRUCTION_UNIFORM},
+    {256, 20, 6, CONSTRUCTION_UNIFORM},
+    {65536, 100, 7, CONSTRUCTION_UNIFORM},
+    {0, 0, 8, CONSTRUCTION_DSATUR},
+    {0, 0, 9, CONSTRUCTION_RLF},
+    {1024, 90, 10, CONSTRUCTION_DSATUR},
+};
+
+/**
+ * @brief Names of the constructions as indexed by the CONSTRUCTION_ values
+ */
+static const char *CONSTRUCTION_NAMES[] = {
+    "uniform",
+    "dsatur",
+    "rlf",
+};
+
 /**
  * Program name
  * @brief Pointer to the program name string
@@ -61,6 +131,21 @@ static volatile sig_atomic_t quitSignalRecieved = false;
 */
 static circular_buffer_data_t *circularBufferData = NULL;
 
+/**
+ * @brief Size of the mapped shared memory segment. Larger than circular_buffer_data_t when backed by huge pages
+ */
+static size_t sharedMemorySize = 0;
+
+/**
+ * @brief Reward and number of worker epochs of every strategy
+ */
+static strategy_stats_t strategyStats[NUM_STRATEGIES];
+
+/**
+ * @brief Number of conflicts of every edge in the results, published to the generators as edge weights
+ */
+static edge_weight_counts_t edgeConflictCounts;
+
 /**
  * @brief Collection of sem_t pointers for all relevant semaphores
  */
@@ -70,6 +155,36 @@ static semaphore_colleciton_t semaphoreCollection = {
     NULL,
 };
 
+/**
+ * @brief The graph sent to remote generators, only loaded with -t
+ */
+static graph_t graph;
+
+/**
+ * @brief The TCP server for remote generators, NULL if it is not running
+ */
+static transport_server_t *transportServer = NULL;
+
+/**
+ * @brief File descriptor of the graph update FIFO, -1 if not open
+ */
+static int deltaFifoFd = -1;
+
+/**
+ * @brief Event file descriptor that wakes the graph update thread for shutdown, -1 if not open
+ */
+static int deltaWakeFd = -1;
+
+/**
+ * @brief The thread reading the graph update FIFO
+ */
+static pthread_t deltaThread;
+
+/**
+ * @brief Whether deltaThread is running
+ */
+static bool deltaThreadStarted = false;
+
 static void cleanup(void);
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -102,7 +217,7 @@ static void printStderrCleaupAndExit(const char *output, ...) {
  * @details global variables: PROGRAM_NAME 
  */
 static void printUsageAndExit(void) {
-    printStderrCleaupAndExit("Usage: %s [-n limit] [-w delay] [-p]\n", PROGRAM_NAME);
+    printStderrCleaupAndExit("Usage: %s [-n limit] [-w delay] [-k colors] [-p] [-H] [-L] [-t port -f graphfile] [-T traceprefix] [-g fifo]\n", PROGRAM_NAME);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -123,9 +238,16 @@ static program_parameters_t parseArguments(int argc, char **argv) {
         -1,
         -1,
         false,
+        false,
+        false,
+        -1,
+        -1,
+        NULL,
+        NULL,
+        NULL,
     };
     int option;
-    while ((option = getopt(argc, argv, ":n:w:p")) != -1) {
+    while ((option = getopt(argc, argv, ":n:w:k:pHLt:f:T:g:")) != -1) {
         switch (option) {
             case 'n':
                 if (programParameters.limit != -1) {
@@ -170,6 +292,22 @@ static program_parameters_t parseArguments(int argc, char **argv) {
                     printUsageAndExit();
                 }
                 break;
+            case 'k':
+                if (programParameters.numColors != -1) {
+                    fprintf(stderr, "[%s] ERROR: multiple colors parameters were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                char *endptr3;
+                programParameters.numColors = strtol(optarg, &endptr3, 10);
+                if (endptr3 == optarg || *endptr3 != '\0') {
+                    fprintf(stderr, "[%s] ERROR: No digits were found in the input string for colors!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                if(programParameters.numColors < 3 || programParameters.numColors > 4) {
+                    fprintf(stderr, "[%s] ERROR: Colors has to be 3 or 4!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                break;
             case 'p':
                 if (programParameters.printGraph) {
                     fprintf(stderr, "[%s] ERROR: Multiple -p parameters were passed!\n", PROGRAM_NAME);
@@ -177,6 +315,57 @@ static program_parameters_t parseArguments(int argc, char **argv) {
                 }
                 programParameters.printGraph = true;
                 break;
+            case 'H':
+                if (programParameters.hugePages) {
+                    fprintf(stderr, "[%s] ERROR: Multiple -H parameters were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                programParameters.hugePages = true;
+                break;
+            case 'L':
+                if (programParameters.lockMemory) {
+                    fprintf(stderr, "[%s] ERROR: Multiple -L parameters were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                programParameters.lockMemory = true;
+                break;
+            case 't':
+                if (programParameters.port != -1) {
+                    fprintf(stderr, "[%s] ERROR: multiple port parameters were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                char *endptr4;
+                programParameters.port = strtol(optarg, &endptr4, 10);
+                if (endptr4 == optarg || *endptr4 != '\0') {
+                    fprintf(stderr, "[%s] ERROR: No digits were found in the input string for port!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                if(programParameters.port < 1 || programParameters.port > 65535) {
+                    fprintf(stderr, "[%s] ERROR: Port has to be between 1 and 65535!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                break;
+            case 'f':
+                if (programParameters.graphFile != NULL) {
+                    fprintf(stderr, "[%s] ERROR: multiple graph files were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                programParameters.graphFile = optarg;
+                break;
+            case 'T':
+                if (programParameters.tracePrefix != NULL) {
+                    fprintf(stderr, "[%s] ERROR: multiple trace prefixes were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                programParameters.tracePrefix = optarg;
+                break;
+            case 'g':
+                if (programParameters.deltaFifo != NULL) {
+                    fprintf(stderr, "[%s] ERROR: multiple update FIFOs were passed!\n", PROGRAM_NAME);
+                    printUsageAndExit();
+                }
+                programParameters.deltaFifo = optarg;
+                break;
             case ':':
                 fprintf(stderr, "[%s] ERROR: Option -%c requires a value!\n", PROGRAM_NAME, optopt);
                 printUsageAndExit();
@@ -189,6 +378,21 @@ static program_parameters_t parseArguments(int argc, char **argv) {
         }
     }
 
+    if (programParameters.numColors == -1) {
+        programParameters.numColors = 3;
+    }
+
+    if ((programParameters.port == -1) != (programParameters.graphFile == NULL)) {
+        fprintf(stderr, "[%s] ERROR: Remote generators need both a port and a graph file!\n", PROGRAM_NAME);
+        printUsageAndExit();
+    }
+
+    // Remote generators receive the graph once when they connect
+    if (programParameters.port != -1 && programParameters.deltaFifo != NULL) {
+        fprintf(stderr, "[%s] ERROR: Live graph updates cannot be combined with remote generators!\n", PROGRAM_NAME);
+        printUsageAndExit();
+    }
+
     if ((argc - optind) > 0) {
         fprintf(stderr, "[%s] ERROR: Too many arguments were passed!\n", PROGRAM_NAME);
         printUsageAndExit();
@@ -210,7 +414,7 @@ static int closeSHM(void) {
     int returnValue = 0;
 
     if(circularBufferData != NULL) {
-        if(munmap(circularBufferData, sizeof(circular_buffer_data_t)) == -1) {
+        if(munmap(circularBufferData, sharedMemorySize) == -1) {
             fprintf(stderr, "[%s] ERROR: Failed to unmap shared memory: %s\n", PROGRAM_NAME, strerror(errno));
             returnValue = -1;
         }
@@ -228,28 +432,71 @@ static int closeSHM(void) {
 }
 
 /**
- * @brief Opens a shared memory space, trucates it to the size of the circular_buffer_data_t object, 
+ * @brief Maps the shared memory file descriptor. With hugePages it first asks for an explicit MAP_HUGETLB mapping
+ *        and falls back to a normal mapping with a transparent huge page hint, since shm_open files usually live on tmpfs.
+ *        With lockMemory the mapping is pre-faulted with MAP_POPULATE.
+ * @details global variables: PROGRAM_NAME, sharedMemorySize
+ * 
+ * @param sharedMemoryFd File descriptor of the shared memory object
+ * @param programParameters The parsed program parameters
+ * @return The mapped address or MAP_FAILED
+ */
+static void* mapSHM(int sharedMemoryFd, program_parameters_t programParameters) {
+    int flags = MAP_SHARED;
+    if(programParameters.lockMemory) {
+        flags |= MAP_POPULATE;
+    }
+
+    if(programParameters.hugePages) {
+        void *address = mmap(NULL, sharedMemorySize, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, sharedMemoryFd, 0);
+        if(address != MAP_FAILED) {
+            return address;
+        }
+        fprintf(stderr, "[%s] WARNING: Explicit huge pages are not available (%s), falling back to transparent huge pages\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    void *address = mmap(NULL, sharedMemorySize, PROT_READ | PROT_WRITE, flags, sharedMemoryFd, 0);
+#ifdef MADV_HUGEPAGE
+    if(address != MAP_FAILED && programParameters.hugePages) {
+        if(madvise(address, sharedMemorySize, MADV_HUGEPAGE) == -1) {
+            fprintf(stderr, "[%s] WARNING: Failed to advise huge pages: %s\n", PROGRAM_NAME, strerror(errno));
+        }
+    }
+#endif
+    return address;
+}
+
+/**
+ * @brief Opens a shared memory space, trucates it to the size of the circular_buffer_data_t object (rounded up to a huge page if requested), 
  *        maps it to an addressspace, closes the fileDescriptor, intialises the circular buffer object and sets the global pointer to that address space.
  *        If something fails it tries to close already opened resources and outputs an error.
- * @details global variables: PROGRAM_NAME, circularBufferData
+ * @details global variables: PROGRAM_NAME, circularBufferData, sharedMemorySize, edgeConflictCounts
+ * 
+ * @param programParameters The parsed program parameters
  */
-static void openSHM(void) {
+static void openSHM(program_parameters_t programParameters) {
     if(circularBufferData != NULL) {
         return;
     }
 
+    sharedMemorySize = sizeof(circular_buffer_data_t);
+    if(programParameters.hugePages) {
+        sharedMemorySize = (sharedMemorySize + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
     int sharedMemoryFd;
     if((sharedMemoryFd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0600)) == -1) {
         printStderrCleaupAndExit("[%s] ERROR: Failed to open shared memory: %s\n", PROGRAM_NAME, strerror(errno));
     }
 
-    if (ftruncate(sharedMemoryFd, sizeof(circular_buffer_data_t)) < 0) {
+    if (ftruncate(sharedMemoryFd, sharedMemorySize) < 0) {
         printStderrCleaupAndExit("[%s] ERROR: Failed to truncate shared memory: %s\n", PROGRAM_NAME, strerror(errno));
     }
 
-    circularBufferData = mmap(NULL, sizeof(circular_buffer_data_t), PROT_READ | PROT_WRITE, MAP_SHARED, sharedMemoryFd, 0);
+    circularBufferData = mapSHM(sharedMemoryFd, programParameters);
 
     if(circularBufferData == MAP_FAILED) {
+        circularBufferData = NULL;
         printStderrCleaupAndExit("[%s] ERROR: Failed to map shared memory: %s\n", PROGRAM_NAME, strerror(errno));
     }
 
@@ -257,17 +504,163 @@ static void openSHM(void) {
         printStderrCleaupAndExit("[%s] ERROR: Failed to close shared memory file descriptor: %s\n", PROGRAM_NAME, strerror(errno));
     }
 
+    if(programParameters.lockMemory && mlock(circularBufferData, sharedMemorySize) == -1) {
+        fprintf(stderr, "[%s] WARNING: Failed to lock shared memory: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
     circularBufferData -> readPos = 0;
     circularBufferData -> writePos = 0;
-    circularBufferData -> stopGenerators = false;
+    circularBufferData -> control.stopGenerators = false;
+    circularBufferData -> control.lockMemory = programParameters.lockMemory;
+    circularBufferData -> control.numColors = programParameters.numColors;
+    circularBufferData -> control.numWorkers = 0;
+    for(int i = 0; i < NUM_STRATEGIES; ++i) {
+        circularBufferData -> strategies[i] = PORTFOLIO[i];
+    }
+    for(int i = 0; i < MAX_NUM_WORKERS; ++i) {
+        circularBufferData -> workers[i].strategy = i % NUM_STRATEGIES;
+        circularBufferData -> workers[i].active = false;
+        circularBufferData -> workers[i].pid = 0;
+    }
+    circularBufferData -> deltaLog.version = 0;
+    circularBufferData -> edgeWeights.sequence = 0;
+    weightsReset(&edgeConflictCounts, &circularBufferData -> edgeWeights);
     for(int i = 0; i < MAX_NUM_RESULT_SETS; ++i) {
+        circularBufferData -> resultSets[i].graphVersion = 0;
+        circularBufferData -> resultSets[i].verdict = VERDICT_UNKNOWN;
         for(int x = 0; x < MAX_NUM_EDGES_RESULT_SET; ++x) {
-            circularBufferData -> resultSets[i][x][0] = -1;
-            circularBufferData -> resultSets[i][x][1] = -1;
+            circularBufferData -> resultSets[i].edges[x][0] = -1;
+            circularBufferData -> resultSets[i].edges[x][1] = -1;
         }
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Portfolio
+
+/**
+ * @brief Credits a result to the strategy that produced it. Smaller results earn more, a new best result earns a bonus
+ * @details global variables: strategyStats
+ * 
+ * @param strategy The strategy the result was tagged with
+ * @param numberOfEdgesInResult The number of edges in the result
+ * @param newBest Whether the result improved the best result
+ */
+static void recordPortfolioResult(int strategy, int numberOfEdgesInResult, bool newBest) {
+    if(strategy < 0 || strategy >= NUM_STRATEGIES) {
+        return;
+    }
+    strategyStats[strategy].reward += (double) (MAX_NUM_EDGES_RESULT_SET + 1 - numberOfEdgesInResult) / (MAX_NUM_EDGES_RESULT_SET + 1);
+    if(newBest) {
+        strategyStats[strategy].reward += 1.0;
+    }
+    ++strategyStats[strategy].results;
+}
+
+/**
+ * @brief Computes the UCB1 score of a strategy, the mean reward per worker epoch plus an exploration bonus
+ * @details global variables: strategyStats
+ * 
+ * @param strategy The strategy
+ * @param assignments Worker epochs per strategy including the assignments of the current rebalancing
+ * @param totalAssignments Sum of assignments
+ * @return The score, infinity for a strategy that was never assigned
+ */
+static double upperConfidenceBound(int strategy, const double *assignments, double totalAssignments) {
+    if(assignments[strategy] == 0) {
+        return HUGE_VAL;
+    }
+    double mean = strategyStats[strategy].reward / (strategyStats[strategy].assignments > 0 ? strategyStats[strategy].assignments : 1);
+    return mean + PORTFOLIO_EXPLORATION * sqrt(log(totalAssignments) / assignments[strategy]);
+}
+
+/**
+ * @brief Ends a portfolio epoch. Every active generator is charged one epoch on its strategy, then every generator
+ *        is reassigned to the strategy with the highest UCB1 score, counting the assignments already made in this round
+ * @details global variables: circularBufferData, strategyStats
+ */
+static void rebalancePortfolio(void) {
+    int numWorkers = __atomic_load_n(&circularBufferData -> control.numWorkers, __ATOMIC_ACQUIRE);
+    if(numWorkers > MAX_NUM_WORKERS) {
+        numWorkers = MAX_NUM_WORKERS;
+    }
+
+    double assignments[NUM_STRATEGIES];
+    double totalAssignments = 0;
+    for(int worker = 0; worker < numWorkers; ++worker) {
+        if(__atomic_load_n(&circularBufferData -> workers[worker].active, __ATOMIC_ACQUIRE)) {
+            strategyStats[circularBufferData -> workers[worker].strategy].assignments += 1;
+        }
+    }
+    for(int strategy = 0; strategy < NUM_STRATEGIES; ++strategy) {
+        assignments[strategy] = strategyStats[strategy].assignments;
+        totalAssignments += assignments[strategy];
+    }
+
+    for(int worker = 0; worker < numWorkers; ++worker) {
+        if(!__atomic_load_n(&circularBufferData -> workers[worker].active, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        int best = 0;
+        double bestScore = -HUGE_VAL;
+        for(int strategy = 0; strategy < NUM_STRATEGIES; ++strategy) {
+            double score = upperConfidenceBound(strategy, assignments, totalAssignments > 1 ? totalAssignments : 1);
+            if(score > bestScore) {
+                best = strategy;
+                bestScore = score;
+            }
+        }
+
+        assignments[best] += 1;
+        totalAssignments += 1;
+        __atomic_store_n(&circularBufferData -> workers[worker].strategy, best, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Prints the statistics of every strategy that produced results
+ * @details global variables: strategyStats, CONSTRUCTION_NAMES
+ */
+static void printPortfolio(void) {
+    for(int strategy = 0; strategy < NUM_STRATEGIES; ++strategy) {
+        if(strategyStats[strategy].results == 0 && strategyStats[strategy].assignments == 0) {
+            continue;
+        }
+        fprintf(stderr, "Strategy %d (%s, restart %ld, bias %d%%): %ld results in %.0f worker epochs, reward %.2f\n", strategy,
+            CONSTRUCTION_NAMES[PORTFOLIO[strategy].construction], PORTFOLIO[strategy].restartInterval, PORTFOLIO[strategy].samplingBias, strategyStats[strategy].results,
+            strategyStats[strategy].assignments, strategyStats[strategy].reward);
+    }
+}
+
+/**
+ * @brief Prints how much duplicate work the shared coloring filter removed
+ * @details global variables: circularBufferData
+ */
+static void printFilterStatistics(void) {
+    const coloring_filter_t *filter = &circularBufferData -> coloringFilter;
+    unsigned long long inserted = __atomic_load_n(&filter -> inserted, __ATOMIC_RELAXED);
+    unsigned long long duplicateResults = __atomic_load_n(&filter -> duplicateResults, __ATOMIC_RELAXED);
+    unsigned long long skippedEvaluations = __atomic_load_n(&filter -> skippedEvaluations, __ATOMIC_RELAXED);
+    if(inserted == 0 && duplicateResults == 0 && skippedEvaluations == 0) {
+        return;
+    }
+    fprintf(stderr, "Coloring filter: %llu distinct results, %llu duplicate results dropped, %llu evaluations skipped\n",
+        inserted, duplicateResults, skippedEvaluations);
+}
+
+/**
+ * @brief Prints how many edges the published edge weights cover
+ * @details global variables: circularBufferData, edgeConflictCounts
+ */
+static void printEdgeWeightStatistics(void) {
+    unsigned long long publications = __atomic_load_n(&circularBufferData -> edgeWeights.sequence, __ATOMIC_RELAXED) / 2;
+    if(publications == 0) {
+        return;
+    }
+    fprintf(stderr, "Edge weights: %zu conflicting edges weighted in %llu publications\n", edgeConflictCounts.used, publications);
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Semaphores
 
@@ -342,6 +735,304 @@ static void openSEM(void) {
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Remote generators
+
+/**
+ * @brief Called by the transport thread for every result of a remote generator. Writes the result into the circular buffer
+ *        exactly like a local generator, so the main loop does not distinguish between them. Remote results carry worker -1
+ *        so the portfolio credits their strategy without reassigning them. The transport thread serves every connection,
+ *        so it never waits for a free slot but lets the transport offer the result again.
+ *        Claims that the graph is not colorable are dropped, no remote generator can prove them to the supervisor
+ * @details global variables: PROGRAM_NAME, semaphoreCollection, circularBufferData
+ * 
+ * @param context Unused
+ * @param result The received result, the transport checked its edges or its coloring against the graph
+ * @return false if the circular buffer is full
+ */
+static bool pushRemoteResult(void *context, const transport_result_t *result) {
+    if(result -> verdict == VERDICT_UNCOLORABLE) {
+        fprintf(stderr, "[%s] WARNING: Ignoring the unverifiable claim of remote generator %d that the graph is not colorable\n", PROGRAM_NAME, result -> connection);
+        return true;
+    }
+
+    if(sem_trywait(semaphoreCollection.wSyncSem) == -1) {
+        if(errno == EAGAIN || errno == EINTR) {
+            return false;
+        }
+        fprintf(stderr, "[%s] ERROR: There was an error waiting the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+        return true;
+    }
+    if(sem_trywait(semaphoreCollection.wSem) == -1) {
+        int error = errno;
+        if(sem_post(semaphoreCollection.wSyncSem) == -1) {
+            fprintf(stderr, "[%s] ERROR: There was an error pushing the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+        }
+        if(error == EAGAIN || error == EINTR) {
+            return false;
+        }
+        fprintf(stderr, "[%s] ERROR: There was an error waiting the semaphore: %s\n", PROGRAM_NAME, strerror(error));
+        return true;
+    }
+
+    result_set_t *resultSet = &circularBufferData -> resultSets[circularBufferData -> writePos];
+    for(size_t i = 0; i < MAX_NUM_EDGES_RESULT_SET; ++i) {
+        resultSet -> edges[i][0] = i < result -> numEdges ? result -> edges[i][0] : -1;
+        resultSet -> edges[i][1] = i < result -> numEdges ? result -> edges[i][1] : -1;
+    }
+    resultSet -> worker = -1;
+    resultSet -> strategy = result -> strategy;
+    resultSet -> verdict = result -> verdict;
+    resultSet -> graphVersion = 0;
+    traceEvent(TRACE_SLOT_WRITE, circularBufferData -> writePos);
+
+    circularBufferData -> writePos = circularBufferData -> writePos + 1;
+    circularBufferData -> writePos = circularBufferData -> writePos % MAX_NUM_RESULT_SETS;
+
+    if(sem_post(semaphoreCollection.rSem) == -1 || sem_post(semaphoreCollection.wSyncSem) == -1) {
+        fprintf(stderr, "[%s] ERROR: There was an error pushing the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+    return true;
+}
+
+/**
+ * @brief Loads the graph file and starts accepting remote generators on the given port
+ * @details global variables: PROGRAM_NAME, graph, transportServer
+ * 
+ * @param programParameters The parsed program parameters
+ */
+static void startTransport(program_parameters_t programParameters) {
+    char graphError[GRAPH_ERROR_SIZE];
+    if(graphLoadFile(&graph, programParameters.graphFile, graphError) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, graphError);
+    }
+    // The transport looks up the edges of every remote result
+    if(graphBuildIndex(&graph) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to index the graph: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    char error[TRANSPORT_ERROR_SIZE];
+    transportServer = transportServerStart((int) programParameters.port, &graph, (int) programParameters.numColors, PORTFOLIO, pushRemoteResult, NULL, error);
+    if(transportServer == NULL) {
+        printStderrCleaupAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, error);
+    }
+}
+
+/**
+ * @brief Stops the transport thread, closes all remote connections and frees the graph
+ * @details global variables: graph, transportServer
+ */
+static void stopTransport(void) {
+    transportServerStop(transportServer);
+    transportServer = NULL;
+    graphFree(&graph);
+}
+
+/**
+ * @brief Classifies the graph loaded for the remote generators, or solves it over a tree decomposition of small width,
+ *        so easy graphs are answered without any generator
+ * @details global variables: PROGRAM_NAME, graph
+ * 
+ * @param numColors The number of colors
+ * @return One of the VERDICT_ values
+ */
+static int classifyLoadedGraph(long numColors) {
+    graph_adjacency_t adjacency;
+    int8_t *colors = malloc(graph.numNodes > 0 ? graph.numNodes : 1);
+    classification_t classification;
+    if(colors == NULL || graphBuildAdjacency(&adjacency, &graph) == -1) {
+        free(colors);
+        cleanup();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to build the adjacency of the graph: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+    int result = classifyGraph(&adjacency, (int) numColors, colors, &classification);
+    size_t width = 0;
+    if(result == 0 && classification.verdict == VERDICT_UNKNOWN) {
+        long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+        int numThreads = numProcessors < 1 ? 1 : numProcessors > TREEDP_MAX_THREADS ? TREEDP_MAX_THREADS : (int) numProcessors;
+        result = classification.verdict = treeDpSolve(&adjacency, (int) numColors, numThreads, colors, &width);
+    }
+    int error = errno;
+    graphFreeAdjacency(&adjacency);
+    free(colors);
+    if(result == -1) {
+        cleanup();
+        printStderrCleaupAndExit("[%s] ERROR: Failed to classify the graph: %s\n", PROGRAM_NAME, strerror(error));
+    }
+
+    if(classification.graphClass != NULL) {
+        fprintf(stderr, "The graph is %s with a largest clique of %zu nodes\n", classification.graphClass, classification.cliqueSize);
+    } else if(classification.verdict != VERDICT_UNKNOWN) {
+        fprintf(stderr, "The graph was solved over a tree decomposition of width %zu\n", width);
+    }
+    return classification.verdict;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Graph updates
+
+/**
+ * @brief Parses one line of the update FIFO and appends it to the delta log. Lines are + {node1}-{node2} to add
+ *        and - {node1}-{node2} to remove an edge, empty lines are ignored
+ * @details global variables: PROGRAM_NAME, circularBufferData
+ * 
+ * @param line The line without the line break
+ */
+static void appendDelta(char *line) {
+    while(*line == ' ' || *line == '\t' || *line == '\r') {
+        ++line;
+    }
+    size_t length = strlen(line);
+    while(length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t' || line[length - 1] == '\r')) {
+        line[--length] = '\0';
+    }
+    if(length == 0) {
+        return;
+    }
+
+    graph_delta_t delta;
+    char *edge = line + 1;
+    while(*edge == ' ' || *edge == '\t') {
+        ++edge;
+    }
+    delta.operation = line[0] == '+' ? GRAPH_DELTA_ADD : line[0] == '-' ? GRAPH_DELTA_REMOVE : 0;
+    if(delta.operation == 0 || graphParseEdgeArgument(edge, delta.nodes) == -1) {
+        fprintf(stderr, "[%s] WARNING: Ignoring graph update \"%s\", expected +{node1}-{node2} or -{node1}-{node2}\n", PROGRAM_NAME, line);
+        return;
+    }
+    if(delta.nodes[0] == delta.nodes[1]) {
+        fprintf(stderr, "[%s] WARNING: Ignoring self-loop on node %ld, it would make the graph uncolorable\n", PROGRAM_NAME, delta.nodes[0]);
+        return;
+    }
+
+    // Only this thread writes the log, so the slot is free until the version is incremented
+    graph_delta_log_t *log = &circularBufferData -> deltaLog;
+    uint64_t version = log -> version;
+    log -> deltas[version % MAX_NUM_GRAPH_DELTAS] = delta;
+    __atomic_store_n(&log -> version, version + 1, __ATOMIC_RELEASE);
+
+    fprintf(stderr, "Graph version %llu: %s edge [%ld, %ld]\n", (unsigned long long) version + 1,
+        delta.operation == GRAPH_DELTA_ADD ? "added" : "removed", delta.nodes[0], delta.nodes[1]);
+}
+
+/**
+ * @brief Reads graph updates from the FIFO until the supervisor shuts down
+ * @details global variables: PROGRAM_NAME, deltaFifoFd, deltaWakeFd
+ */
+static void* readDeltas(void *argument) {
+    char line[DELTA_LINE_SIZE];
+    size_t lineLength = 0;
+    bool lineTooLong = false;
+
+    struct pollfd fds[2];
+    fds[0].fd = deltaFifoFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = deltaWakeFd;
+    fds[1].events = POLLIN;
+
+    while(true) {
+        if(poll(fds, 2, -1) == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "[%s] ERROR: Failed to wait for graph updates: %s\n", PROGRAM_NAME, strerror(errno));
+            return NULL;
+        }
+        if(fds[1].revents != 0) {
+            return NULL;
+        }
+
+        char buffer[DELTA_LINE_SIZE];
+        ssize_t received = read(deltaFifoFd, buffer, sizeof(buffer));
+        if(received == -1) {
+            if(errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            fprintf(stderr, "[%s] ERROR: Failed to read graph updates: %s\n", PROGRAM_NAME, strerror(errno));
+            return NULL;
+        }
+
+        for(ssize_t i = 0; i < received; ++i) {
+            if(buffer[i] != '\n') {
+                if(lineLength + 1 < sizeof(line)) {
+                    line[lineLength++] = buffer[i];
+                } else {
+                    lineTooLong = true;
+                }
+                continue;
+            }
+
+            line[lineLength] = '\0';
+            if(lineTooLong) {
+                fprintf(stderr, "[%s] WARNING: Ignoring graph update longer than %d bytes\n", PROGRAM_NAME, DELTA_LINE_SIZE);
+            } else {
+                appendDelta(line);
+            }
+            lineLength = 0;
+            lineTooLong = false;
+        }
+    }
+}
+
+/**
+ * @brief Creates the update FIFO and starts the thread that appends its lines to the delta log.
+ *        The FIFO is opened for reading and writing so it never reports end of file when a writer closes it.
+ * @details global variables: PROGRAM_NAME, deltaFifoFd, deltaWakeFd, deltaThread, deltaThreadStarted
+ * 
+ * @param path Path of the FIFO
+ */
+static void startDeltaReader(const char *path) {
+    if(mkfifo(path, 0600) == -1 && errno != EEXIST) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to create update FIFO %s: %s\n", PROGRAM_NAME, path, strerror(errno));
+    }
+    if((deltaFifoFd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC)) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to open update FIFO %s: %s\n", PROGRAM_NAME, path, strerror(errno));
+    }
+    struct stat fifoStat;
+    if(fstat(deltaFifoFd, &fifoStat) == -1 || !S_ISFIFO(fifoStat.st_mode)) {
+        printStderrCleaupAndExit("[%s] ERROR: %s is not a FIFO\n", PROGRAM_NAME, path);
+    }
+    if((deltaWakeFd = eventfd(0, EFD_CLOEXEC)) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to create event: %s\n", PROGRAM_NAME, strerror(errno));
+    }
+
+    // Signals have to reach the main thread
+    sigset_t allSignals;
+    sigset_t previousSignals;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousSignals);
+    int result = pthread_create(&deltaThread, NULL, readDeltas, NULL);
+    pthread_sigmask(SIG_SETMASK, &previousSignals, NULL);
+    if(result != 0) {
+        printStderrCleaupAndExit("[%s] ERROR: Failed to start update thread: %s\n", PROGRAM_NAME, strerror(result));
+    }
+    deltaThreadStarted = true;
+}
+
+/**
+ * @brief Stops the update thread and closes the FIFO
+ * @details global variables: PROGRAM_NAME, deltaFifoFd, deltaWakeFd, deltaThread, deltaThreadStarted
+ */
+static void stopDeltaReader(void) {
+    if(deltaThreadStarted) {
+        uint64_t value = 1;
+        if(write(deltaWakeFd, &value, sizeof(value)) == -1) {
+            fprintf(stderr, "[%s] ERROR: Failed to wake update thread: %s\n", PROGRAM_NAME, strerror(errno));
+        } else {
+            pthread_join(deltaThread, NULL);
+        }
+        deltaThreadStarted = false;
+    }
+    if(deltaFifoFd != -1) {
+        close(deltaFifoFd);
+        deltaFifoFd = -1;
+    }
+    if(deltaWakeFd != -1) {
+        close(deltaWakeFd);
+        deltaWakeFd = -1;
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Singnal handler
 
@@ -373,14 +1064,17 @@ static void registerSignalHandler(void) {
 
 /**
  * @brief Cleans up everything there is to clean up.
- *        It stops the generators and closes the shared memory as well as the semaphores
+ *        It stops the remote and local generators and closes the shared memory as well as the semaphores
  * @details circularBufferData, PROGRAM_NAME
  * 
  */
 static void cleanup(void) {
     bool error = false;
+    stopTransport();
+    stopDeltaReader();
+
     if(circularBufferData != NULL && semaphoreCollection.wSem != NULL) {
-        circularBufferData -> stopGenerators = true;
+        circularBufferData -> control.stopGenerators = true;
         int semValue = 0;
         while(semValue < MAX_NUM_RESULT_SETS) {
             if(sem_getvalue(semaphoreCollection.wSem, &semValue) == -1) {
@@ -404,6 +1098,12 @@ static void cleanup(void) {
         error = true;
     }
 
+    char traceError[TRACE_ERROR_SIZE];
+    if(traceClose(traceError) == -1) {
+        fprintf(stderr, "[%s] ERROR: %s\n", PROGRAM_NAME, traceError);
+        error = true;
+    }
+
     if(error) {
         exit(EXIT_FAILURE);
     }
@@ -414,7 +1114,7 @@ static void cleanup(void) {
 
 /**
  * @brief Program entry point
- * @details global variables: PROGRAM_NAME, semaphoreCollection, circularBufferData, quitSignalRecieved
+ * @details global variables: PROGRAM_NAME, semaphoreCollection, circularBufferData, quitSignalRecieved, edgeConflictCounts
  * 
  * @param argc The argument counter
  * @param argv The argument vector
@@ -426,19 +1126,41 @@ int main(int argc, char **argv) {
 
     program_parameters_t programParameters = parseArguments(argc, argv);
 
-    openSHM();
+    char traceError[TRACE_ERROR_SIZE];
+    if(programParameters.tracePrefix != NULL && traceOpen(programParameters.tracePrefix, "supervisor", traceError) == -1) {
+        printStderrCleaupAndExit("[%s] ERROR: %s\n", PROGRAM_NAME, traceError);
+    }
+
+    openSHM(programParameters);
     openSEM();
 
+    if(programParameters.port != -1) {
+        startTransport(programParameters);
+    }
+    if(programParameters.deltaFifo != NULL) {
+        startDeltaReader(programParameters.deltaFifo);
+    }
+
     // Wait if the delay is set
     if(programParameters.delay > 0) {
         sleep(programParameters.delay);
     }
     
+    // The graph of the remote generators never changes, easy ones need no search at all
+    int verdict = VERDICT_UNKNOWN;
+    if(programParameters.graphFile != NULL) {
+        verdict = classifyLoadedGraph(programParameters.numColors);
+    }
+
     long readCounter = 0;
     long bestResultSet[MAX_NUM_EDGES_RESULT_SET][2];
-    int numberOfEdgesInBestResult = MAX_NUM_EDGES_RESULT_SET + 1;
-    while(!quitSignalRecieved && (programParameters.limit < 1 || readCounter < programParameters.limit)) {
-        if(sem_wait(semaphoreCollection.rSem) == -1) {
+    int numberOfEdgesInBestResult = verdict == VERDICT_COLORABLE ? 0 : MAX_NUM_EDGES_RESULT_SET + 1;
+    uint64_t bestGraphVersion = 0;
+    while(verdict == VERDICT_UNKNOWN && !quitSignalRecieved && (programParameters.limit < 1 || readCounter < programParameters.limit)) {
+        traceEvent(TRACE_SEM_WAIT_BEGIN, TRACE_SEM_R);
+        int waitResult = sem_wait(semaphoreCollection.rSem);
+        traceEvent(TRACE_SEM_WAIT_END, TRACE_SEM_R);
+        if(waitResult == -1) {
             if(errno == EINTR) {
                 continue;
             }
@@ -446,24 +1168,59 @@ int main(int argc, char **argv) {
             printStderrCleaupAndExit("[%s] ERROR: There was an error waiting for the semaphore: %s\n", PROGRAM_NAME, strerror(errno));
         }
 
+        traceEvent(TRACE_SLOT_READ, circularBufferData -> readPos);
+
+        // The best result of an older graph may not even be a solution of the current one
+        uint64_t graphVersion = __atomic_load_n(&circularBufferData -> deltaLog.version, __ATOMIC_ACQUIRE);
+        if(graphVersion != bestGraphVersion) {
+            if(numberOfEdgesInBestResult <= MAX_NUM_EDGES_RESULT_SET) {
+                fprintf(stderr, "Graph changed to version %llu, discarding the best result\n", (unsigned long long) graphVersion);
+            }
+            numberOfEdgesInBestResult = MAX_NUM_EDGES_RESULT_SET + 1;
+            bestGraphVersion = graphVersion;
+            // The conflict counts belong to the old graph as well
+            weightsReset(&edgeConflictCounts, &circularBufferData -> edgeWeights);
+        }
+
+        // Results found on an older graph are dropped
+        bool stale = circularBufferData -> resultSets[circularBufferData -> readPos].graphVersion != graphVersion;
+
         int numberOfEdgesInResult = 0;
-        for(int i = 0; i < MAX_NUM_EDGES_RESULT_SET && circularBufferData -> resultSets[circularBufferData -> readPos][i][0] != -1; i++) {
+        for(int i = 0; i < MAX_NUM_EDGES_RESULT_SET && circularBufferData -> resultSets[circularBufferData -> readPos].edges[i][0] != -1; i++) {
             numberOfEdgesInResult++;
         }
 
+        // Break the loop if a generator proved that there is no coloring
+        if(!stale && circularBufferData -> resultSets[circularBufferData -> readPos].verdict == VERDICT_UNCOLORABLE) {
+            verdict = VERDICT_UNCOLORABLE;
+            break;
+        }
+
         // Break the loop if the result set is empty so the graph is three colorable
-        if(numberOfEdgesInResult == 0) {
+        if(!stale && numberOfEdgesInResult == 0) {
+            traceEvent(TRACE_NEW_BEST, 0);
             numberOfEdgesInBestResult = 0;
             break;
         }
 
+        bool newBest = !stale && numberOfEdgesInResult < numberOfEdgesInBestResult;
+        if(!stale) {
+            recordPortfolioResult(circularBufferData -> resultSets[circularBufferData -> readPos].strategy, numberOfEdgesInResult, newBest);
+            // Edges that keep showing up in the results get heavier for the generators. Edges beyond the capacity of the table keep weight 1
+            for(int i = 0; i < numberOfEdgesInResult; ++i) {
+                weightsRecordConflict(&edgeConflictCounts, circularBufferData -> resultSets[circularBufferData -> readPos].edges[i][0],
+                    circularBufferData -> resultSets[circularBufferData -> readPos].edges[i][1]);
+            }
+        }
+
         // Save the new better result if it is better
-        if(numberOfEdgesInResult < numberOfEdgesInBestResult) {
+        if(newBest) {
             for(int i = 0; i < MAX_NUM_EDGES_RESULT_SET; ++i) {
-                bestResultSet[i][0] = circularBufferData -> resultSets[circularBufferData -> readPos][i][0];
-                bestResultSet[i][1] = circularBufferData -> resultSets[circularBufferData -> readPos][i][1];
+                bestResultSet[i][0] = circularBufferData -> resultSets[circularBufferData -> readPos].edges[i][0];
+                bestResultSet[i][1] = circularBufferData -> resultSets[circularBufferData -> readPos].edges[i][1];
             }
             numberOfEdgesInBestResult = numberOfEdgesInResult;
+            traceEvent(TRACE_NEW_BEST, numberOfEdgesInResult);
 
             fprintf(stderr, "New best result found:\n");
             for(int i = 0; i < MAX_NUM_EDGES_RESULT_SET && bestResultSet[i][0] != -1; ++i) {
@@ -480,12 +1237,24 @@ int main(int argc, char **argv) {
         }
 
         ++readCounter;
+        if(readCounter % PORTFOLIO_EPOCH_RESULTS == 0) {
+            rebalancePortfolio();
+        }
+        if(readCounter % EDGE_WEIGHT_PUBLISH_RESULTS == 0) {
+            weightsPublish(&edgeConflictCounts, &circularBufferData -> edgeWeights);
+        }
     }
 
-    if(numberOfEdgesInBestResult == 0) {
-        printf("The graph is 3-colorable!\n");
+    printPortfolio();
+    printFilterStatistics();
+    printEdgeWeightStatistics();
+
+    if(verdict == VERDICT_UNCOLORABLE) {
+        printf("The graph is not %ld-colorable!\n", programParameters.numColors);
+    } else if(numberOfEdgesInBestResult == 0) {
+        printf("The graph is %ld-colorable!\n", programParameters.numColors);
     } else {
-        printf("The graph might not be 3-colorable, best solution removes %d edges.\n", numberOfEdgesInBestResult);
+        printf("The graph might not be %ld-colorable, best solution removes %d edges.\n", programParameters.numColors, numberOfEdgesInBestResult);
     }
 
     cleanup();
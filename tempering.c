@@ -0,0 +1,397 @@
+/**
+ * @file tempering.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Parallel tempering search with lock-free replica exchange between threads
+ *
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+
+#include "tempering.h"
+
+#define SLOT_EMPTY 0
+#define SLOT_WRITING 1
+#define SLOT_WAITING 2
+#define SLOT_TAKING 3
+#define SLOT_ANSWERED 4
+
+/**
+ * @brief Number of polls after which a level stops waiting for its partner in an exchange
+ */
+#define EXCHANGE_SPINS (1 << 16)
+
+/**
+ * @brief Number of moves a helper level runs between two looks at the exchange epoch
+ */
+#define EPOCH_CHECK_INTERVAL 256
+
+/**
+ * @brief Percent of the moves that recolor a conflicting node instead of any node
+ */
+#define CONFLICT_MOVE_PERCENT 90
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Replicas
+
+/**
+ * @brief Adds a node to the conflicting set of a replica
+ */
+static inline void addConflicting(tempering_replica_t *replica, uint32_t node) {
+    replica -> position[node] = (uint32_t) replica -> numConflicting;
+    replica -> conflicting[replica -> numConflicting++] = node;
+}
+
+/**
+ * @brief Removes a node from the conflicting set of a replica by moving the last member into its place
+ */
+static inline void removeConflicting(tempering_replica_t *replica, uint32_t node) {
+    uint32_t last = replica -> conflicting[--replica -> numConflicting];
+    replica -> conflicting[replica -> position[node]] = last;
+    replica -> position[last] = replica -> position[node];
+}
+
+/**
+ * @brief Allocates a replica and draws a uniform random coloring for it
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int createReplica(tempering_replica_t *replica, const graph_adjacency_t *adjacency, int numColors, rng_state_t *rng) {
+    size_t numNodes = adjacency -> numNodes > 0 ? adjacency -> numNodes : 1;
+    replica -> colors = malloc(numNodes);
+    replica -> conflicts = malloc(sizeof(uint32_t) * numNodes);
+    replica -> conflicting = malloc(sizeof(uint32_t) * numNodes);
+    replica -> position = malloc(sizeof(uint32_t) * numNodes);
+    if(replica -> colors == NULL || replica -> conflicts == NULL || replica -> conflicting == NULL || replica -> position == NULL) {
+        return -1;
+    }
+
+    for(size_t node = 0; node < adjacency -> numNodes; ++node) {
+        replica -> colors[node] = (uint8_t) rngBelow(rng, (uint32_t) numColors);
+    }
+    replica -> numConflicting = 0;
+    replica -> cost = 0;
+    for(uint32_t node = 0; node < adjacency -> numNodes; ++node) {
+        uint32_t conflicts = 0;
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            conflicts += replica -> colors[adjacency -> neighbors[i]] == replica -> colors[node];
+        }
+        replica -> conflicts[node] = conflicts;
+        replica -> cost += conflicts;
+        if(conflicts > 0) {
+            addConflicting(replica, node);
+        }
+    }
+    // Every conflict was counted at both of its nodes
+    replica -> cost /= 2;
+    return 0;
+}
+
+/**
+ * @brief Frees the arrays of a replica
+ */
+static void freeReplica(tempering_replica_t *replica) {
+    free(replica -> colors);
+    free(replica -> conflicts);
+    free(replica -> conflicting);
+    free(replica -> position);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Moves
+
+/**
+ * @brief Proposes one recoloring on the replica of a level and accepts it with the Metropolis probability of its temperature
+ */
+static inline void move(tempering_level_t *level) {
+    const graph_adjacency_t *adjacency = level -> tempering -> adjacency;
+    tempering_replica_t *replica = level -> replica;
+    int numColors = level -> tempering -> numColors;
+
+    uint32_t node;
+    if(replica -> numConflicting > 0 && rngBelow(&level -> rng, 100) < CONFLICT_MOVE_PERCENT) {
+        node = replica -> conflicting[rngBelow(&level -> rng, (uint32_t) replica -> numConflicting)];
+    } else {
+        node = rngBelow(&level -> rng, (uint32_t) adjacency -> numNodes);
+    }
+    int oldColor = replica -> colors[node];
+    int newColor = (oldColor + 1 + (int) rngBelow(&level -> rng, (uint32_t) numColors - 1)) % numColors;
+
+    // Only the edges of the node change, so the change of cost is the difference of its conflicts
+    uint32_t newConflicts = 0;
+    for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+        newConflicts += replica -> colors[adjacency -> neighbors[i]] == newColor;
+    }
+    if(newConflicts > replica -> conflicts[node]) {
+        uint32_t delta = newConflicts - replica -> conflicts[node];
+        if(delta > TEMPERING_MAX_DELTA || (uint32_t) (rngNext(&level -> rng) >> 32) >= level -> thresholds[delta]) {
+            return;
+        }
+    }
+
+    for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+        uint32_t neighbor = adjacency -> neighbors[i];
+        if(replica -> colors[neighbor] == oldColor) {
+            if(--replica -> conflicts[neighbor] == 0) {
+                removeConflicting(replica, neighbor);
+            }
+        } else if(replica -> colors[neighbor] == newColor) {
+            if(replica -> conflicts[neighbor]++ == 0) {
+                addConflicting(replica, neighbor);
+            }
+        }
+    }
+    if(replica -> conflicts[node] > 0 && newConflicts == 0) {
+        removeConflicting(replica, node);
+    } else if(replica -> conflicts[node] == 0 && newConflicts > 0) {
+        addConflicting(replica, node);
+    }
+    replica -> cost = replica -> cost + newConflicts - replica -> conflicts[node];
+    replica -> conflicts[node] = newConflicts;
+    replica -> colors[node] = (uint8_t) newColor;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Exchange
+
+/**
+ * @brief Decides whether two levels swap their replicas and tells the waiting one through the slot
+ *
+ * @param level The level that arrived second
+ * @param slot The slot holding the offer of the other level
+ */
+static void answerOffer(tempering_level_t *level, tempering_slot_t *slot) {
+    const tempering_level_t *other = &level -> tempering -> levels[slot -> offeredLevel];
+    double costDifference = (double) level -> replica -> cost - (double) slot -> offered -> cost;
+    double exponent = (level -> beta - other -> beta) * costDifference;
+    double uniform = (double) (rngNext(&level -> rng) >> 11) * (1.0 / 9007199254740992.0);
+
+    if(exponent >= 0 || uniform < exp(exponent)) {
+        tempering_replica_t *offered = slot -> offered;
+        slot -> answer = level -> replica;
+        level -> replica = offered;
+    } else {
+        slot -> answer = slot -> offered;
+    }
+    __atomic_store_n(&slot -> state, SLOT_ANSWERED, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Offers the replica of a level in a slot and waits for the partner to answer or gives up
+ *
+ * @param level The level that arrived first
+ * @param slot The slot in the writing state
+ */
+static void offerReplica(tempering_level_t *level, tempering_slot_t *slot) {
+    slot -> offered = level -> replica;
+    slot -> offeredLevel = level -> level;
+    __atomic_store_n(&slot -> state, SLOT_WAITING, __ATOMIC_RELEASE);
+
+    for(long spin = 0;; ++spin) {
+        uint32_t state = __atomic_load_n(&slot -> state, __ATOMIC_ACQUIRE);
+        if(state == SLOT_ANSWERED) {
+            level -> replica = slot -> answer;
+            __atomic_store_n(&slot -> state, SLOT_EMPTY, __ATOMIC_RELEASE);
+            return;
+        }
+        // Withdrawing only works before the partner took the offer, afterwards its answer is on the way
+        uint32_t expected = SLOT_WAITING;
+        if((spin >= EXCHANGE_SPINS || __atomic_load_n(&level -> tempering -> stop, __ATOMIC_RELAXED)) &&
+            __atomic_compare_exchange_n(&slot -> state, &expected, SLOT_EMPTY, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Meets the partner level of an epoch in the slot between both. Even epochs pair levels 0-1, 2-3, ...,
+ *        odd epochs pair levels 1-2, 3-4, ...
+ *
+ * @param level The level
+ * @param epoch The exchange epoch
+ */
+static void exchange(tempering_level_t *level, uint64_t epoch) {
+    tempering_t *tempering = level -> tempering;
+    int lower = (uint64_t) (level -> level % 2) == epoch % 2 ? level -> level : level -> level - 1;
+    if(lower < 0 || lower + 1 >= tempering -> numReplicas) {
+        return;
+    }
+
+    tempering_slot_t *slot = &tempering -> slots[lower];
+    for(long spin = 0; spin < EXCHANGE_SPINS; ++spin) {
+        uint32_t expected = __atomic_load_n(&slot -> state, __ATOMIC_ACQUIRE);
+        if(expected == SLOT_EMPTY) {
+            if(__atomic_compare_exchange_n(&slot -> state, &expected, SLOT_WRITING, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                offerReplica(level, slot);
+                return;
+            }
+        } else if(expected == SLOT_WAITING) {
+            if(__atomic_compare_exchange_n(&slot -> state, &expected, SLOT_TAKING, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                answerOffer(level, slot);
+                return;
+            }
+        }
+        // Otherwise the partner is in the middle of writing an offer or collecting an answer of an earlier epoch
+    }
+}
+
+/**
+ * @brief Thread function of every level but the coldest. Runs moves and takes part in every new exchange epoch
+ *
+ * @param argument The level
+ * @return NULL
+ */
+static void* runLevel(void *argument) {
+    tempering_level_t *level = argument;
+    tempering_t *tempering = level -> tempering;
+    uint64_t lastEpoch = 0;
+
+    while(!__atomic_load_n(&tempering -> stop, __ATOMIC_RELAXED)) {
+        for(int i = 0; i < EPOCH_CHECK_INTERVAL; ++i) {
+            move(level);
+        }
+        uint64_t epoch = __atomic_load_n(&tempering -> epoch, __ATOMIC_RELAXED);
+        if(epoch != lastEpoch) {
+            lastEpoch = epoch;
+            exchange(level, epoch);
+        }
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Ladder
+
+int temperingCreate(tempering_t *tempering, const graph_adjacency_t *adjacency, int numColors, int numReplicas, uint64_t seed) {
+    memset(tempering, 0, sizeof(*tempering));
+    if(numReplicas < 2 || numReplicas > TEMPERING_MAX_REPLICAS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    tempering -> adjacency = adjacency;
+    tempering -> numColors = numColors;
+    tempering -> numReplicas = numReplicas;
+    tempering -> bestReported = SIZE_MAX;
+    tempering -> replicas = calloc(numReplicas, sizeof(tempering_replica_t));
+    tempering -> threads = malloc(sizeof(pthread_t) * numReplicas);
+    // Levels and slots are written by different threads and must not share cache lines
+    void *levels = NULL;
+    void *slots = NULL;
+    int levelsResult = posix_memalign(&levels, CACHE_LINE_SIZE, sizeof(tempering_level_t) * numReplicas);
+    int slotsResult = posix_memalign(&slots, CACHE_LINE_SIZE, sizeof(tempering_slot_t) * numReplicas);
+    tempering -> levels = levelsResult == 0 ? levels : NULL;
+    tempering -> slots = slotsResult == 0 ? slots : NULL;
+    if(tempering -> replicas == NULL || tempering -> levels == NULL || tempering -> slots == NULL || tempering -> threads == NULL) {
+        temperingFree(tempering);
+        errno = levelsResult != 0 ? levelsResult : slotsResult != 0 ? slotsResult : ENOMEM;
+        return -1;
+    }
+    memset(tempering -> levels, 0, sizeof(tempering_level_t) * numReplicas);
+    memset(tempering -> slots, 0, sizeof(tempering_slot_t) * numReplicas);
+
+    for(int i = 0; i < numReplicas; ++i) {
+        tempering_level_t *level = &tempering -> levels[i];
+        level -> tempering = tempering;
+        level -> level = i;
+        rngSeed(&level -> rng, seed + (uint64_t) i * 0x9E3779B97F4A7C15ULL);
+
+        // Temperatures grow geometrically from the coldest to the hottest level
+        double temperature = TEMPERING_MIN_TEMPERATURE * pow(TEMPERING_MAX_TEMPERATURE / TEMPERING_MIN_TEMPERATURE, (double) i / (numReplicas - 1));
+        level -> beta = 1.0 / temperature;
+        for(int delta = 0; delta <= TEMPERING_MAX_DELTA; ++delta) {
+            double probability = exp(-delta * level -> beta);
+            level -> thresholds[delta] = probability >= 1.0 ? UINT32_MAX : (uint32_t) (probability * 4294967296.0);
+        }
+
+        if(createReplica(&tempering -> replicas[i], adjacency, numColors, &level -> rng) == -1) {
+            temperingFree(tempering);
+            return -1;
+        }
+        level -> replica = &tempering -> replicas[i];
+    }
+    return 0;
+}
+
+int temperingStart(tempering_t *tempering) {
+    // Without nodes there is nothing to move, so the hotter levels are not started, like temperingRun does not move
+    if(tempering -> adjacency -> numNodes == 0) {
+        return 0;
+    }
+
+    // Signals have to reach the main thread
+    sigset_t allSignals;
+    sigset_t previousSignals;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousSignals);
+    int result = 0;
+    for(int i = 1; i < tempering -> numReplicas && result == 0; ++i) {
+        result = pthread_create(&tempering -> threads[tempering -> numThreads], NULL, runLevel, &tempering -> levels[i]);
+        if(result == 0) {
+            ++tempering -> numThreads;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &previousSignals, NULL);
+    return result;
+}
+
+size_t temperingRun(tempering_t *tempering, long moves, uint32_t (*conflicts)[2], size_t maxConflicts) {
+    const graph_adjacency_t *adjacency = tempering -> adjacency;
+    tempering_level_t *level = &tempering -> levels[0];
+    if(adjacency -> numNodes == 0) {
+        return 0;
+    }
+
+    for(long i = 0; i < moves; ++i) {
+        if(--level -> movesUntilExchange <= 0) {
+            level -> movesUntilExchange = TEMPERING_EXCHANGE_INTERVAL;
+            exchange(level, __atomic_add_fetch(&tempering -> epoch, 1, __ATOMIC_RELAXED));
+        }
+        move(level);
+
+        tempering_replica_t *replica = level -> replica;
+        if(replica -> cost >= maxConflicts || replica -> cost >= tempering -> bestReported) {
+            continue;
+        }
+
+        // Every conflicting edge is reported once, from its smaller node
+        size_t found = 0;
+        for(size_t c = 0; c < replica -> numConflicting; ++c) {
+            uint32_t node = replica -> conflicting[c];
+            for(uint32_t n = adjacency -> offsets[node]; n < adjacency -> offsets[node + 1]; ++n) {
+                uint32_t neighbor = adjacency -> neighbors[n];
+                if(node < neighbor && replica -> colors[neighbor] == replica -> colors[node]) {
+                    conflicts[found][0] = node;
+                    conflicts[found][1] = neighbor;
+                    ++found;
+                }
+            }
+        }
+        tempering -> bestReported = replica -> cost;
+        return replica -> cost;
+    }
+    return maxConflicts;
+}
+
+void temperingFree(tempering_t *tempering) {
+    __atomic_store_n(&tempering -> stop, true, __ATOMIC_RELAXED);
+    for(int i = 0; i < tempering -> numThreads; ++i) {
+        pthread_join(tempering -> threads[i], NULL);
+    }
+    if(tempering -> replicas != NULL) {
+        for(int i = 0; i < tempering -> numReplicas; ++i) {
+            freeReplica(&tempering -> replicas[i]);
+        }
+    }
+    free(tempering -> replicas);
+    free(tempering -> levels);
+    free(tempering -> slots);
+    free(tempering -> threads);
+    memset(tempering, 0, sizeof(*tempering));
+}
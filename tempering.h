@@ -0,0 +1,135 @@
+/**
+ * @file tempering.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the parallel tempering search
+ * @details Every level of a geometric temperature ladder runs Metropolis recoloring moves on one replica, level 0 on
+ *          the calling thread and every other level on its own thread. Moves pick a conflicting node most of the time
+ *          and compute their change of cost from the neighbors only. Every TEMPERING_EXCHANGE_INTERVAL moves the levels
+ *          of alternating adjacent pairs meet in the lock-free exchange slot between them and swap their replicas with
+ *          the replica exchange acceptance probability, so good colorings sink to the coldest level.
+ *
+ **/
+
+#ifndef TEMPERING_H_FILE
+#define TEMPERING_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "commons.h"
+#include "graph.h"
+#include "rng.h"
+
+#define TEMPERING_MAX_REPLICAS 64
+#define TEMPERING_MIN_TEMPERATURE 0.25
+#define TEMPERING_MAX_TEMPERATURE 2.5
+#define TEMPERING_EXCHANGE_INTERVAL 4096
+
+/**
+ * @brief Changes of cost up to this size have a precomputed acceptance threshold, larger ones are always rejected
+ */
+#define TEMPERING_MAX_DELTA 16
+
+/**
+ * @brief A coloring together with the number of conflicts of every node and the set of conflicting nodes
+ *
+ */
+typedef struct {
+    uint8_t *colors;
+    uint32_t *conflicts;
+    uint32_t *conflicting;
+    uint32_t *position;
+    size_t numConflicting;
+    size_t cost;
+} tempering_replica_t;
+
+/**
+ * @brief Meeting point of two adjacent levels. The state word moves from empty over writing to waiting when the first
+ *        level offers its replica, and over taking to answered when the second one decides. Only the state word is
+ *        written with compare and swap, the other fields belong to whoever moved the state last
+ *
+ */
+typedef struct {
+    uint32_t state CACHE_ALIGNED;
+    tempering_replica_t *offered;
+    tempering_replica_t *answer;
+    int offeredLevel;
+} tempering_slot_t;
+
+/**
+ * @brief One temperature of the ladder and the replica it currently holds
+ *
+ */
+typedef struct {
+    struct tempering *tempering;
+    int level;
+    double beta;
+    uint32_t thresholds[TEMPERING_MAX_DELTA + 1];
+    tempering_replica_t *replica;
+    rng_state_t rng;
+    long movesUntilExchange;
+} CACHE_ALIGNED tempering_level_t;
+
+/**
+ * @brief The whole ladder with its threads. The coldest level advances the exchange epoch every
+ *        TEMPERING_EXCHANGE_INTERVAL moves, the other levels exchange once for every epoch they see
+ *
+ */
+typedef struct tempering {
+    const graph_adjacency_t *adjacency;
+    int numColors;
+    int numReplicas;
+    tempering_replica_t *replicas;
+    tempering_level_t *levels;
+    tempering_slot_t *slots;
+    pthread_t *threads;
+    int numThreads;
+    bool stop;
+    uint64_t epoch;
+    size_t bestReported;
+} tempering_t;
+
+/**
+ * @brief Allocates the replicas with uniform random colorings and the temperature ladder
+ *
+ * @param tempering The tempering state to initialise
+ * @param adjacency The adjacency of the graph, has to outlive the tempering state
+ * @param numColors The number of colors
+ * @param numReplicas The number of replicas, 2 to TEMPERING_MAX_REPLICAS
+ * @param seed Seed of the random streams of all levels
+ * @return 0 on success, -1 with errno set on failure
+ */
+int temperingCreate(tempering_t *tempering, const graph_adjacency_t *adjacency, int numColors, int numReplicas, uint64_t seed);
+
+/**
+ * @brief Starts one thread for every level but the coldest
+ *
+ * @param tempering The tempering state
+ * @return 0 on success, an error number on failure
+ */
+int temperingStart(tempering_t *tempering);
+
+/**
+ * @brief Runs moves on the coldest level and reports its replica if it is better than every one reported before
+ *
+ * @param tempering The tempering state
+ * @param moves Number of moves to run
+ * @param conflicts Output buffer for the conflicting edges as node index pairs
+ * @param maxConflicts Number of conflicts from which on a coloring is unusable
+ * @return Number of conflicts of the reported coloring, maxConflicts if there was no new best one
+ */
+size_t temperingRun(tempering_t *tempering, long moves, uint32_t (*conflicts)[2], size_t maxConflicts);
+
+/**
+ * @brief Stops and joins the threads and frees all memory
+ *
+ * @param tempering The tempering state to free
+ */
+void temperingFree(tempering_t *tempering);
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file trace.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Lane management and dumping of the binary event tracing
+ *
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "trace.h"
+
+#define TRACE_PATH_SIZE 4096
+
+bool traceEnabled = false;
+
+__thread trace_lane_t *traceCurrentLane = NULL;
+
+/**
+ * @brief Lanes of all threads of this process
+ */
+static trace_lane_t lanes[TRACE_MAX_LANES];
+
+/**
+ * @brief Number of claimed lanes, may exceed TRACE_MAX_LANES if too many threads recorded events
+ */
+static int numClaimedLanes = 0;
+
+/**
+ * @brief Path of the trace file
+ */
+static char tracePath[TRACE_PATH_SIZE];
+
+/**
+ * @brief Program name stored in the trace file
+ */
+static char traceRole[TRACE_ROLE_SIZE];
+
+static const char *EVENT_NAMES[TRACE_NUM_EVENT_TYPES] = {
+    "evaluate begin",
+    "evaluate end",
+    "semaphore wait begin",
+    "semaphore wait end",
+    "slot write",
+    "slot read",
+    "new best",
+};
+
+const char* traceEventName(uint32_t type) {
+    return type < TRACE_NUM_EVENT_TYPES ? EVENT_NAMES[type] : "unknown";
+}
+
+int traceOpen(const char *prefix, const char *role, char *error) {
+    if(snprintf(tracePath, sizeof(tracePath), "%s.%ld.trace", prefix, (long) getpid()) >= (int) sizeof(tracePath)) {
+        snprintf(error, TRACE_ERROR_SIZE, "Trace prefix is too long");
+        return -1;
+    }
+    memset(traceRole, 0, sizeof(traceRole));
+    strncpy(traceRole, role, sizeof(traceRole) - 1);
+
+    // Fail now rather than after the whole run
+    FILE *file = fopen(tracePath, "wb");
+    if(file == NULL) {
+        snprintf(error, TRACE_ERROR_SIZE, "Failed to create trace file: %s", strerror(errno));
+        return -1;
+    }
+    fclose(file);
+
+    traceEnabled = true;
+    return 0;
+}
+
+trace_lane_t* traceClaimLane(void) {
+    int index = __atomic_fetch_add(&numClaimedLanes, 1, __ATOMIC_ACQ_REL);
+    if(index >= TRACE_MAX_LANES) {
+        return NULL;
+    }
+
+    trace_lane_t *lane = &lanes[index];
+    if((lane -> events = malloc(sizeof(trace_event_t) * TRACE_LANE_CAPACITY)) == NULL) {
+        return NULL;
+    }
+    lane -> tid = (pid_t) syscall(SYS_gettid);
+    lane -> count = 0;
+    lane -> dropped = 0;
+    traceCurrentLane = lane;
+    return lane;
+}
+
+int traceClose(char *error) {
+    if(!traceEnabled) {
+        return 0;
+    }
+    traceEnabled = false;
+
+    int numLanes = __atomic_load_n(&numClaimedLanes, __ATOMIC_ACQUIRE);
+    if(numLanes > TRACE_MAX_LANES) {
+        numLanes = TRACE_MAX_LANES;
+    }
+
+    FILE *file = fopen(tracePath, "wb");
+    if(file == NULL) {
+        snprintf(error, TRACE_ERROR_SIZE, "Failed to open trace file: %s", strerror(errno));
+        return -1;
+    }
+
+    trace_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.pid = (int32_t) getpid();
+    header.numLanes = 0;
+    for(int i = 0; i < numLanes; ++i) {
+        if(lanes[i].events != NULL) {
+            ++header.numLanes;
+        }
+    }
+    memcpy(header.role, traceRole, sizeof(header.role));
+
+    bool failed = fwrite(&header, sizeof(header), 1, file) != 1;
+    for(int i = 0; i < numLanes && !failed; ++i) {
+        if(lanes[i].events == NULL) {
+            continue;
+        }
+        trace_lane_header_t laneHeader;
+        memset(&laneHeader, 0, sizeof(laneHeader));
+        laneHeader.tid = lanes[i].tid;
+        laneHeader.numEvents = lanes[i].count;
+        laneHeader.dropped = lanes[i].dropped;
+        failed = fwrite(&laneHeader, sizeof(laneHeader), 1, file) != 1 ||
+            fwrite(lanes[i].events, sizeof(trace_event_t), lanes[i].count, file) != lanes[i].count;
+    }
+    if(failed) {
+        snprintf(error, TRACE_ERROR_SIZE, "Failed to write trace file: %s", strerror(errno));
+    }
+    if(fclose(file) != 0 && !failed) {
+        snprintf(error, TRACE_ERROR_SIZE, "Failed to close trace file: %s", strerror(errno));
+        failed = true;
+    }
+
+    for(int i = 0; i < numLanes; ++i) {
+        free(lanes[i].events);
+        lanes[i].events = NULL;
+    }
+    return failed ? -1 : 0;
+}
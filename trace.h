@@ -0,0 +1,162 @@
+/**
+ * @file trace.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the binary event tracing of the supervisor and the generators
+ * @details Every thread that records an event claims its own lane, so recording needs neither locks nor atomics.
+ *          Timestamps come from CLOCK_MONOTONIC_RAW, which is shared by all processes, so traces of the supervisor
+ *          and the generators line up. At exit every process dumps its lanes to {prefix}.{pid}.trace, tracedump
+ *          converts one or more of these files to the Chrome trace event JSON format.
+ *
+ **/
+
+#ifndef TRACE_H_FILE
+#define TRACE_H_FILE
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/types.h>
+
+#include "commons.h"
+
+#define TRACE_ERROR_SIZE 256
+#define TRACE_MAX_LANES 8
+#define TRACE_LANE_CAPACITY (1 << 20)
+#define TRACE_ROLE_SIZE 16
+#define TRACE_MAGIC "3CTRACE1"
+
+/**
+ * @brief Recorded event types. BEGIN and END events form durations, all others are instants
+ */
+typedef enum {
+    TRACE_EVALUATE_BEGIN,
+    TRACE_EVALUATE_END,
+    TRACE_SEM_WAIT_BEGIN,
+    TRACE_SEM_WAIT_END,
+    TRACE_SLOT_WRITE,
+    TRACE_SLOT_READ,
+    TRACE_NEW_BEST,
+    TRACE_NUM_EVENT_TYPES
+} trace_event_type_t;
+
+/**
+ * @brief Arguments of the semaphore wait events
+ */
+typedef enum {
+    TRACE_SEM_R,
+    TRACE_SEM_W,
+    TRACE_SEM_W_SYNC
+} trace_semaphore_t;
+
+/**
+ * @brief One recorded event, also the on-disk format
+ */
+typedef struct {
+    uint64_t timestamp;
+    uint32_t type;
+    int32_t argument;
+} trace_event_t;
+
+/**
+ * @brief Header of a trace file, followed by numLanes lanes
+ */
+typedef struct {
+    char magic[8];
+    int32_t pid;
+    uint32_t numLanes;
+    char role[TRACE_ROLE_SIZE];
+} trace_file_header_t;
+
+/**
+ * @brief Header of a lane in a trace file, followed by numEvents events
+ */
+typedef struct {
+    int32_t tid;
+    uint32_t reserved;
+    uint64_t numEvents;
+    uint64_t dropped;
+} trace_lane_header_t;
+
+/**
+ * @brief The events of one thread. Only the owning thread writes to it
+ */
+typedef struct {
+    pid_t tid;
+    size_t count;
+    size_t dropped;
+    trace_event_t *events;
+} CACHE_ALIGNED trace_lane_t;
+
+/**
+ * @brief Whether tracing is enabled, checked before anything else when recording an event
+ */
+extern bool traceEnabled;
+
+/**
+ * @brief The lane of the calling thread, NULL until it recorded its first event
+ */
+extern __thread trace_lane_t *traceCurrentLane;
+
+/**
+ * @brief Enables tracing for this process
+ *
+ * @param prefix The trace is written to {prefix}.{pid}.trace at traceClose
+ * @param role Name of the program shown in the converted trace
+ * @param error Buffer of TRACE_ERROR_SIZE bytes for the error message
+ * @return 0 on success, -1 on failure
+ */
+int traceOpen(const char *prefix, const char *role, char *error);
+
+/**
+ * @brief Writes the trace file and disables tracing. Other threads must not record events anymore. Does nothing if tracing is disabled
+ *
+ * @param error Buffer of TRACE_ERROR_SIZE bytes for the error message
+ * @return 0 on success, -1 on failure
+ */
+int traceClose(char *error);
+
+/**
+ * @brief Claims a lane for the calling thread
+ *
+ * @return The lane or NULL if all lanes are taken
+ */
+trace_lane_t* traceClaimLane(void);
+
+/**
+ * @brief Returns the name of an event type
+ */
+const char* traceEventName(uint32_t type);
+
+/**
+ * @brief Records an event on the lane of the calling thread. Costs a single branch if tracing is disabled
+ *
+ * @param type The event type
+ * @param argument Slot, semaphore or number of edges depending on the type
+ */
+static inline void traceEvent(trace_event_type_t type, int32_t argument) {
+    if(!traceEnabled) {
+        return;
+    }
+
+    trace_lane_t *lane = traceCurrentLane;
+    if(lane == NULL && (lane = traceClaimLane()) == NULL) {
+        return;
+    }
+    if(lane -> count == TRACE_LANE_CAPACITY) {
+        ++lane -> dropped;
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    trace_event_t *event = &lane -> events[lane -> count++];
+    event -> timestamp = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+    event -> type = type;
+    event -> argument = argument;
+}
+
+#endif
@@ -0,0 +1,226 @@
+/**
+ * @file tracedump.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Main-file of the trace converter
+ * @details Reads the binary traces the supervisor and the generators write with -T and prints them as one
+ *          Chrome trace event JSON document, which chrome://tracing and Perfetto can open.
+ *          Timestamps are shifted so that the earliest event of all files is at 0.
+ *
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "trace.h"
+
+/**
+ * Program name
+ * @brief Pointer to the program name string
+ */
+static const char *PROGRAM_NAME;
+
+/**
+ * @brief Whether an event was already printed, every following one needs a separating comma
+ */
+static bool printedEvent = false;
+
+/**
+ * @brief Names of the semaphores as used in the semaphore wait events
+ */
+static const char *SEMAPHORE_NAMES[] = {
+    "rSem",
+    "wSem",
+    "wSyncSem",
+};
+
+/**
+ * @brief Prints the separator before an event
+ * @details global variables: printedEvent
+ */
+static void beginEvent(void) {
+    printf(printedEvent ? ",\n" : "\n");
+    printedEvent = true;
+}
+
+/**
+ * @brief Prints one event in the Chrome trace event format
+ *
+ * @param event The event
+ * @param pid The process of the event
+ * @param tid The thread of the event
+ * @param origin Timestamp that becomes 0
+ */
+static void printEvent(const trace_event_t *event, int pid, int tid, uint64_t origin) {
+    double timestamp = (double) (event -> timestamp - origin) / 1000.0;
+    const char *semaphore = event -> argument >= 0 && event -> argument <= TRACE_SEM_W_SYNC ? SEMAPHORE_NAMES[event -> argument] : "unknown";
+
+    beginEvent();
+    switch(event -> type) {
+        case TRACE_EVALUATE_BEGIN:
+        case TRACE_EVALUATE_END:
+            printf("{\"name\":\"evaluate\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                event -> type == TRACE_EVALUATE_BEGIN ? "B" : "E", timestamp, pid, tid);
+            break;
+        case TRACE_SEM_WAIT_BEGIN:
+        case TRACE_SEM_WAIT_END:
+            printf("{\"name\":\"wait %s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                semaphore, event -> type == TRACE_SEM_WAIT_BEGIN ? "B" : "E", timestamp, pid, tid);
+            break;
+        case TRACE_SLOT_WRITE:
+        case TRACE_SLOT_READ:
+            printf("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"slot\":%d}}",
+                traceEventName(event -> type), timestamp, pid, tid, event -> argument);
+            break;
+        case TRACE_NEW_BEST:
+            printf("{\"name\":\"new best\",\"ph\":\"i\",\"s\":\"p\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"edges\":%d}}",
+                timestamp, pid, tid, event -> argument);
+            break;
+        default:
+            printf("{\"name\":\"unknown %u\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}", event -> type, timestamp, pid, tid);
+            break;
+    }
+}
+
+/**
+ * @brief Reads the header of a trace file and checks the magic
+ *
+ * @return 0 on success, -1 on failure
+ */
+static int readHeader(FILE *file, const char *path, trace_file_header_t *header) {
+    if(fread(header, sizeof(*header), 1, file) != 1 || memcmp(header -> magic, TRACE_MAGIC, sizeof(header -> magic)) != 0) {
+        fprintf(stderr, "[%s] ERROR: %s is not a trace file\n", PROGRAM_NAME, path);
+        return -1;
+    }
+    header -> role[TRACE_ROLE_SIZE - 1] = '\0';
+    return 0;
+}
+
+/**
+ * @brief Finds the earliest timestamp in a trace file
+ *
+ * @param path Path of the trace file
+ * @param origin Lowered to the earliest timestamp of the file
+ * @return 0 on success, -1 on failure
+ */
+static int findOrigin(const char *path, uint64_t *origin) {
+    FILE *file = fopen(path, "rb");
+    if(file == NULL) {
+        fprintf(stderr, "[%s] ERROR: Failed to open %s: %s\n", PROGRAM_NAME, path, strerror(errno));
+        return -1;
+    }
+
+    trace_file_header_t header;
+    if(readHeader(file, path, &header) == -1) {
+        fclose(file);
+        return -1;
+    }
+    for(uint32_t lane = 0; lane < header.numLanes; ++lane) {
+        trace_lane_header_t laneHeader;
+        trace_event_t event;
+        if(fread(&laneHeader, sizeof(laneHeader), 1, file) != 1) {
+            break;
+        }
+        // Events of a lane are in order, the first one is the earliest
+        if(laneHeader.numEvents > 0 && fread(&event, sizeof(event), 1, file) == 1) {
+            if(event.timestamp < *origin) {
+                *origin = event.timestamp;
+            }
+            fseek(file, (long) ((laneHeader.numEvents - 1) * sizeof(trace_event_t)), SEEK_CUR);
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Prints all events of a trace file together with the process and thread names
+ *
+ * @param path Path of the trace file
+ * @param origin Timestamp that becomes 0
+ * @return 0 on success, -1 on failure
+ */
+static int convertFile(const char *path, uint64_t origin) {
+    FILE *file = fopen(path, "rb");
+    if(file == NULL) {
+        fprintf(stderr, "[%s] ERROR: Failed to open %s: %s\n", PROGRAM_NAME, path, strerror(errno));
+        return -1;
+    }
+
+    trace_file_header_t header;
+    if(readHeader(file, path, &header) == -1) {
+        fclose(file);
+        return -1;
+    }
+    beginEvent();
+    printf("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s %d\"}}", header.pid, header.role, header.pid);
+
+    for(uint32_t lane = 0; lane < header.numLanes; ++lane) {
+        trace_lane_header_t laneHeader;
+        if(fread(&laneHeader, sizeof(laneHeader), 1, file) != 1) {
+            fprintf(stderr, "[%s] ERROR: %s is truncated\n", PROGRAM_NAME, path);
+            fclose(file);
+            return -1;
+        }
+        beginEvent();
+        printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            header.pid, laneHeader.tid, laneHeader.tid == header.pid ? "main" : "worker");
+        if(laneHeader.dropped > 0) {
+            fprintf(stderr, "[%s] WARNING: %s dropped %llu events of thread %d, the lane was full\n", PROGRAM_NAME, path,
+                (unsigned long long) laneHeader.dropped, laneHeader.tid);
+        }
+
+        for(uint64_t i = 0; i < laneHeader.numEvents; ++i) {
+            trace_event_t event;
+            if(fread(&event, sizeof(event), 1, file) != 1) {
+                fprintf(stderr, "[%s] ERROR: %s is truncated\n", PROGRAM_NAME, path);
+                fclose(file);
+                return -1;
+            }
+            printEvent(&event, header.pid, laneHeader.tid, origin);
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Program entry point
+ * @details global variables: PROGRAM_NAME
+ *
+ * @param argc The argument counter
+ * @param argv The argument vector
+ * @return Returns EXIT_SUCCESS on program success
+ */
+int main(int argc, char **argv) {
+    PROGRAM_NAME = argv[0];
+    if(argc < 2) {
+        fprintf(stderr, "Usage: %s TRACEFILE...\nPrints the traces as Chrome trace event JSON to stdout\n", PROGRAM_NAME);
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t origin = UINT64_MAX;
+    for(int i = 1; i < argc; ++i) {
+        if(findOrigin(argv[i], &origin) == -1) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for(int i = 1; i < argc; ++i) {
+        if(convertFile(argv[i], origin) == -1) {
+            exit(EXIT_FAILURE);
+        }
+    }
+    printf("\n]}\n");
+
+    return EXIT_SUCCESS;
+}
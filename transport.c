@@ -0,0 +1,844 @@
+/**
+ * @file transport.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief TCP transport between the supervisor and remote generators
+ * @details The server side runs in its own thread and multiplexes the listening socket and all connections with epoll.
+ *          The graph frame is encoded once and shared by all connections, only the short hello part differs per connection.
+ *
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "transport.h"
+
+#define GRAPH_HELLO_SIZE 36
+#define GRAPH_EDGE_SIZE 16
+#define RESULT_FIXED_SIZE 12
+#define COLORING_FIXED_SIZE 4
+#define RESULT_MAX_PAYLOAD (RESULT_FIXED_SIZE + MAX_NUM_EDGES_RESULT_SET * GRAPH_EDGE_SIZE)
+#define INPUT_BUFFER_SIZE (4 * (FRAME_HEADER_SIZE + RESULT_MAX_PAYLOAD))
+#define RECEIVE_CHUNK_EDGES 4096
+#define MAX_EPOLL_EVENTS 64
+#define LISTEN_TOKEN UINT32_MAX
+#define WAKE_TOKEN (UINT32_MAX - 1)
+
+/**
+ * @brief Time after which the server offers the held back result of a blocked connection again
+ */
+#define BLOCKED_RETRY_MS 10
+
+/**
+ * @brief State of one remote generator connection. The input buffer grows to hold a coloring frame.
+ *        A blocked connection holds back a result the callback could not take and is not read until it took it
+ *
+ */
+typedef struct {
+    int fd;
+    uint8_t hello[FRAME_HEADER_SIZE + GRAPH_HELLO_SIZE];
+    size_t outputSent;
+    bool waitingForOutput;
+    uint8_t *input;
+    size_t inputCapacity;
+    size_t inputSize;
+    bool blocked;
+} connection_t;
+
+struct transport_server {
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    pthread_t thread;
+    bool threadStarted;
+    bool stop;
+
+    const graph_t *graph;
+    int numColors;
+    const strategy_config_t *strategies;
+    int nextStrategy;
+    uint8_t *edgePayload;
+    size_t edgePayloadSize;
+    size_t coloringPayloadSize;
+    int numBlocked;
+
+    transport_result_callback_t onResult;
+    void *context;
+    connection_t connections[TRANSPORT_MAX_CONNECTIONS];
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Encoding
+
+static void putU32(uint8_t *buffer, uint32_t value) {
+    buffer[0] = (uint8_t) (value >> 24);
+    buffer[1] = (uint8_t) (value >> 16);
+    buffer[2] = (uint8_t) (value >> 8);
+    buffer[3] = (uint8_t) value;
+}
+
+static void putU64(uint8_t *buffer, uint64_t value) {
+    putU32(buffer, (uint32_t) (value >> 32));
+    putU32(buffer + 4, (uint32_t) value);
+}
+
+static uint32_t getU32(const uint8_t *buffer) {
+    return ((uint32_t) buffer[0] << 24) | ((uint32_t) buffer[1] << 16) | ((uint32_t) buffer[2] << 8) | (uint32_t) buffer[3];
+}
+
+static uint64_t getU64(const uint8_t *buffer) {
+    return ((uint64_t) getU32(buffer) << 32) | getU32(buffer + 4);
+}
+
+/**
+ * @brief Writes a frame header
+ *
+ * @param buffer Buffer of at least FRAME_HEADER_SIZE bytes
+ * @param payloadSize Size of the payload following the header
+ * @param type The frame type
+ */
+static void putHeader(uint8_t *buffer, uint32_t payloadSize, uint32_t type) {
+    putU32(buffer, payloadSize);
+    putU32(buffer + 4, type);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Server
+
+/**
+ * @brief Closes a connection and frees its slot
+ */
+static void closeConnection(transport_server_t *server, int index) {
+    connection_t *connection = &server -> connections[index];
+    if(connection -> fd != -1) {
+        if(connection -> blocked) {
+            connection -> blocked = false;
+            --server -> numBlocked;
+        } else {
+            epoll_ctl(server -> epollFd, EPOLL_CTL_DEL, connection -> fd, NULL);
+        }
+        close(connection -> fd);
+        connection -> fd = -1;
+    }
+}
+
+/**
+ * @brief Sends as much of the pending graph frame as the socket accepts. Stops waiting for EPOLLOUT once everything was sent.
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int flushConnection(transport_server_t *server, int index) {
+    connection_t *connection = &server -> connections[index];
+    size_t total = sizeof(connection -> hello) + server -> edgePayloadSize;
+
+    while(connection -> outputSent < total) {
+        const uint8_t *data;
+        size_t size;
+        if(connection -> outputSent < sizeof(connection -> hello)) {
+            data = connection -> hello + connection -> outputSent;
+            size = sizeof(connection -> hello) - connection -> outputSent;
+        } else {
+            data = server -> edgePayload + (connection -> outputSent - sizeof(connection -> hello));
+            size = total - connection -> outputSent;
+        }
+
+        ssize_t sent = send(connection -> fd, data, size, MSG_NOSIGNAL);
+        if(sent == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            return -1;
+        }
+        connection -> outputSent += sent;
+    }
+
+    if(connection -> waitingForOutput) {
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = (uint32_t) index;
+        if(epoll_ctl(server -> epollFd, EPOLL_CTL_MOD, connection -> fd, &event) == -1) {
+            return -1;
+        }
+        connection -> waitingForOutput = false;
+    }
+    return 0;
+}
+
+/**
+ * @brief Accepts all pending connections, assigns each a strategy and starts sending the graph
+ */
+static void acceptConnections(transport_server_t *server) {
+    while(true) {
+        int fd = accept(server -> listenFd, NULL, NULL);
+        if(fd == -1) {
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                fprintf(stderr, "[transport] WARNING: Failed to accept connection: %s\n", strerror(errno));
+            }
+            if(errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        int index = 0;
+        while(index < TRANSPORT_MAX_CONNECTIONS && server -> connections[index].fd != -1) {
+            ++index;
+        }
+        if(index == TRANSPORT_MAX_CONNECTIONS) {
+            fprintf(stderr, "[transport] WARNING: Rejecting connection, all %d slots are taken\n", TRANSPORT_MAX_CONNECTIONS);
+            close(fd);
+            continue;
+        }
+
+        connection_t *connection = &server -> connections[index];
+        if(connection -> input == NULL) {
+            if((connection -> input = malloc(INPUT_BUFFER_SIZE)) == NULL) {
+                fprintf(stderr, "[transport] WARNING: Failed to allocate connection buffer: %s\n", strerror(errno));
+                close(fd);
+                continue;
+            }
+            connection -> inputCapacity = INPUT_BUFFER_SIZE;
+        }
+
+        int flags = fcntl(fd, F_GETFL);
+        if(flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1 || fcntl(fd, F_SETFD, FD_CLOEXEC) == -1) {
+            fprintf(stderr, "[transport] WARNING: Failed to configure connection: %s\n", strerror(errno));
+            close(fd);
+            continue;
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        connection -> fd = fd;
+        connection -> outputSent = 0;
+        connection -> inputSize = 0;
+        connection -> waitingForOutput = true;
+
+        int strategy = server -> nextStrategy;
+        server -> nextStrategy = (server -> nextStrategy + 1) % NUM_STRATEGIES;
+        uint8_t *hello = connection -> hello;
+        putHeader(hello, (uint32_t) (GRAPH_HELLO_SIZE + server -> edgePayloadSize), FRAME_GRAPH);
+        putU32(hello + 8, (uint32_t) server -> numColors);
+        putU32(hello + 12, (uint32_t) strategy);
+        putU64(hello + 16, (uint64_t) server -> strategies[strategy].restartInterval);
+        putU32(hello + 24, (uint32_t) server -> strategies[strategy].samplingBias);
+        putU32(hello + 28, (uint32_t) server -> strategies[strategy].seedStream);
+        putU64(hello + 32, (uint64_t) server -> graph -> numEdges);
+        putU32(hello + 40, (uint32_t) server -> strategies[strategy].construction);
+
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLOUT;
+        event.data.u32 = (uint32_t) index;
+        if(epoll_ctl(server -> epollFd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            fprintf(stderr, "[transport] WARNING: Failed to watch connection: %s\n", strerror(errno));
+            close(fd);
+            connection -> fd = -1;
+        }
+    }
+}
+
+/**
+ * @brief Checks that every edge of a result is an edge of the graph the generators search
+ */
+static bool isGraphEdgeSet(const transport_server_t *server, const transport_result_t *result) {
+    for(size_t i = 0; i < result -> numEdges; ++i) {
+        long u = graphFindNode(server -> graph, result -> edges[i][0]);
+        long v = graphFindNode(server -> graph, result -> edges[i][1]);
+        if(u == -1 || v == -1 || u == v || graphFindEdge(server -> graph, (uint32_t) u, (uint32_t) v) == -1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks that packed two bit colors in the order of the graph nodes use only the allowed colors and leave
+ *        no edge monochromatic
+ */
+static bool isProperColoring(const transport_server_t *server, const uint8_t *packed) {
+    const graph_t *graph = server -> graph;
+    for(size_t node = 0; node < graph -> numNodes; ++node) {
+        if(((packed[node >> 2] >> ((node & 3) * 2)) & 3) >= server -> numColors) {
+            return false;
+        }
+    }
+    for(size_t i = 0; i < graph -> numEdges; ++i) {
+        uint32_t u = graph -> edges[i][0];
+        uint32_t v = graph -> edges[i][1];
+        if(((packed[u >> 2] >> ((u & 3) * 2)) & 3) == ((packed[v >> 2] >> ((v & 3) * 2)) & 3)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes a result or coloring frame. A result without edges claims a coloring, which the generator has to
+ *        send as a coloring frame instead so it can be checked
+ *
+ * @return 0 on success, -1 if the frame is invalid or its claim is false
+ */
+static int decodeFrame(const transport_server_t *server, uint32_t type, const uint8_t *payload, uint32_t payloadSize, transport_result_t *result) {
+    result -> strategy = (int32_t) getU32(payload);
+    if(type == FRAME_COLORING) {
+        result -> numEdges = 0;
+        result -> verdict = VERDICT_COLORABLE;
+        return isProperColoring(server, payload + COLORING_FIXED_SIZE) ? 0 : -1;
+    }
+
+    result -> numEdges = getU32(payload + 4);
+    result -> verdict = (int32_t) getU32(payload + 8);
+    if(result -> numEdges > MAX_NUM_EDGES_RESULT_SET || payloadSize != RESULT_FIXED_SIZE + result -> numEdges * GRAPH_EDGE_SIZE) {
+        return -1;
+    }
+    if(result -> numEdges == 0 && result -> verdict != VERDICT_UNCOLORABLE) {
+        return -1;
+    }
+    for(size_t i = 0; i < result -> numEdges; ++i) {
+        result -> edges[i][0] = (long) getU64(payload + RESULT_FIXED_SIZE + i * GRAPH_EDGE_SIZE);
+        result -> edges[i][1] = (long) getU64(payload + RESULT_FIXED_SIZE + i * GRAPH_EDGE_SIZE + 8);
+    }
+    return isGraphEdgeSet(server, result) ? 0 : -1;
+}
+
+/**
+ * @brief Parses all complete frames in the input buffer of a connection and passes results to the callback.
+ *        A result the callback cannot take stays in the buffer with the frames behind it
+ *
+ * @return 0 on success, 1 if the callback could not take a result, -1 if the peer sent an invalid frame
+ */
+static int processInput(transport_server_t *server, int index) {
+    connection_t *connection = &server -> connections[index];
+    size_t offset = 0;
+    bool held = false;
+
+    while(connection -> inputSize - offset >= FRAME_HEADER_SIZE) {
+        const uint8_t *frame = connection -> input + offset;
+        uint32_t payloadSize = getU32(frame);
+        uint32_t type = getU32(frame + 4);
+        if(type == FRAME_COLORING ? payloadSize != server -> coloringPayloadSize :
+            type != FRAME_RESULT || payloadSize < RESULT_FIXED_SIZE || payloadSize > RESULT_MAX_PAYLOAD) {
+            return -1;
+        }
+        if(connection -> inputSize - offset < FRAME_HEADER_SIZE + payloadSize) {
+            // Only coloring frames can be larger than the buffer
+            if(FRAME_HEADER_SIZE + payloadSize > connection -> inputCapacity) {
+                uint8_t *input = realloc(connection -> input, FRAME_HEADER_SIZE + payloadSize);
+                if(input == NULL) {
+                    return -1;
+                }
+                connection -> input = input;
+                connection -> inputCapacity = FRAME_HEADER_SIZE + payloadSize;
+            }
+            break;
+        }
+
+        transport_result_t result;
+        result.connection = index;
+        if(decodeFrame(server, type, frame + FRAME_HEADER_SIZE, payloadSize, &result) == -1) {
+            return -1;
+        }
+        if(!server -> onResult(server -> context, &result)) {
+            held = true;
+            break;
+        }
+
+        offset += FRAME_HEADER_SIZE + payloadSize;
+    }
+
+    memmove(connection -> input, connection -> input + offset, connection -> inputSize - offset);
+    connection -> inputSize -= offset;
+    return held ? 1 : 0;
+}
+
+/**
+ * @brief Offers the held back results of all blocked connections again and resumes reading the ones that passed them on
+ */
+static void retryBlocked(transport_server_t *server) {
+    for(int index = 0; index < TRANSPORT_MAX_CONNECTIONS && server -> numBlocked > 0; ++index) {
+        connection_t *connection = &server -> connections[index];
+        if(connection -> fd == -1 || !connection -> blocked) {
+            continue;
+        }
+
+        int result = processInput(server, index);
+        if(result == -1) {
+            fprintf(stderr, "[transport] WARNING: Dropping connection %d after an invalid frame\n", index);
+            closeConnection(server, index);
+            continue;
+        }
+        if(result == 1) {
+            continue;
+        }
+
+        connection -> blocked = false;
+        --server -> numBlocked;
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = (uint32_t) index;
+        if(epoll_ctl(server -> epollFd, EPOLL_CTL_ADD, connection -> fd, &event) == -1) {
+            closeConnection(server, index);
+        }
+    }
+}
+
+/**
+ * @brief Reads everything available on a connection
+ *
+ * @return 0 on success, -1 if the connection was closed or failed
+ */
+static int readConnection(transport_server_t *server, int index) {
+    connection_t *connection = &server -> connections[index];
+    while(true) {
+        ssize_t received = recv(connection -> fd, connection -> input + connection -> inputSize, connection -> inputCapacity - connection -> inputSize, 0);
+        if(received == 0) {
+            return -1;
+        }
+        if(received == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        }
+        connection -> inputSize += received;
+        int result = processInput(server, index);
+        if(result == -1) {
+            fprintf(stderr, "[transport] WARNING: Dropping connection %d after an invalid frame\n", index);
+            return -1;
+        }
+        if(result == 1) {
+            // The rest waits in the socket until retryBlocked passed the held back result on
+            epoll_ctl(server -> epollFd, EPOLL_CTL_DEL, connection -> fd, NULL);
+            connection -> blocked = true;
+            ++server -> numBlocked;
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief Event loop of the server thread
+ */
+static void* serverThread(void *argument) {
+    transport_server_t *server = argument;
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+
+    while(!__atomic_load_n(&server -> stop, __ATOMIC_ACQUIRE)) {
+        int numEvents = epoll_wait(server -> epollFd, events, MAX_EPOLL_EVENTS, server -> numBlocked > 0 ? BLOCKED_RETRY_MS : -1);
+        if(numEvents == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "[transport] ERROR: Failed to wait for events: %s\n", strerror(errno));
+            break;
+        }
+
+        for(int i = 0; i < numEvents; ++i) {
+            uint32_t token = events[i].data.u32;
+            if(token == WAKE_TOKEN) {
+                uint64_t value;
+                if(read(server -> wakeFd, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+                    fprintf(stderr, "[transport] WARNING: Failed to read wake event: %s\n", strerror(errno));
+                }
+                continue;
+            }
+            if(token == LISTEN_TOKEN) {
+                acceptConnections(server);
+                continue;
+            }
+
+            int index = (int) token;
+            if(server -> connections[index].fd == -1 || server -> connections[index].blocked) {
+                continue;
+            }
+            if((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && readConnection(server, index) == -1) {
+                closeConnection(server, index);
+                continue;
+            }
+            if((events[i].events & EPOLLOUT) && flushConnection(server, index) == -1) {
+                closeConnection(server, index);
+            }
+        }
+        retryBlocked(server);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Encodes the edges of the graph once for all connections
+ *
+ * @return 0 on success, -1 on failure
+ */
+static int encodeEdges(transport_server_t *server, char *error) {
+    const graph_t *graph = server -> graph;
+    if(GRAPH_HELLO_SIZE + graph -> numEdges * GRAPH_EDGE_SIZE > UINT32_MAX) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "The graph is too large to be sent in one frame");
+        return -1;
+    }
+
+    server -> edgePayloadSize = graph -> numEdges * GRAPH_EDGE_SIZE;
+    if((server -> edgePayload = malloc(server -> edgePayloadSize > 0 ? server -> edgePayloadSize : 1)) == NULL) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to allocate graph frame: %s", strerror(errno));
+        return -1;
+    }
+    for(size_t i = 0; i < graph -> numEdges; ++i) {
+        putU64(server -> edgePayload + i * GRAPH_EDGE_SIZE, (uint64_t) graph -> nodeIds[graph -> edges[i][0]]);
+        putU64(server -> edgePayload + i * GRAPH_EDGE_SIZE + 8, (uint64_t) graph -> nodeIds[graph -> edges[i][1]]);
+    }
+    return 0;
+}
+
+/**
+ * @brief Creates the listening socket, the epoll instance and the wake event of the server
+ *
+ * @return 0 on success, -1 on failure
+ */
+static int openServerSockets(transport_server_t *server, int port, char *error) {
+    if((server -> listenFd = socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) == -1) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to create socket: %s", strerror(errno));
+        return -1;
+    }
+
+    // Accept IPv4 connections on the same socket
+    int value = 0;
+    setsockopt(server -> listenFd, IPPROTO_IPV6, IPV6_V6ONLY, &value, sizeof(value));
+    value = 1;
+    setsockopt(server -> listenFd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
+
+    struct sockaddr_in6 address;
+    memset(&address, 0, sizeof(address));
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons((uint16_t) port);
+    if(bind(server -> listenFd, (struct sockaddr*) &address, sizeof(address)) == -1) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to bind port %d: %s", port, strerror(errno));
+        return -1;
+    }
+    if(listen(server -> listenFd, SOMAXCONN) == -1) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to listen on port %d: %s", port, strerror(errno));
+        return -1;
+    }
+
+    if((server -> epollFd = epoll_create1(EPOLL_CLOEXEC)) == -1 || (server -> wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to create event loop: %s", strerror(errno));
+        return -1;
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = LISTEN_TOKEN;
+    if(epoll_ctl(server -> epollFd, EPOLL_CTL_ADD, server -> listenFd, &event) == -1) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to watch listening socket: %s", strerror(errno));
+        return -1;
+    }
+    event.data.u32 = WAKE_TOKEN;
+    if(epoll_ctl(server -> epollFd, EPOLL_CTL_ADD, server -> wakeFd, &event) == -1) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to watch wake event: %s", strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
+transport_server_t* transportServerStart(int port, const graph_t *graph, int numColors, const strategy_config_t *strategies,
+    transport_result_callback_t onResult, void *context, char *error) {
+    transport_server_t *server = calloc(1, sizeof(transport_server_t));
+    if(server == NULL) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to allocate server: %s", strerror(errno));
+        return NULL;
+    }
+
+    server -> listenFd = -1;
+    server -> epollFd = -1;
+    server -> wakeFd = -1;
+    server -> graph = graph;
+    server -> numColors = numColors;
+    server -> strategies = strategies;
+    server -> onResult = onResult;
+    server -> context = context;
+    server -> coloringPayloadSize = COLORING_FIXED_SIZE + (graph -> numNodes + 3) / 4;
+    for(int i = 0; i < TRANSPORT_MAX_CONNECTIONS; ++i) {
+        server -> connections[i].fd = -1;
+    }
+
+    if(encodeEdges(server, error) == -1 || openServerSockets(server, port, error) == -1) {
+        transportServerStop(server);
+        return NULL;
+    }
+
+    // Signals have to reach the main thread of the supervisor, not the server thread
+    sigset_t allSignals;
+    sigset_t previousSignals;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousSignals);
+    int result = pthread_create(&server -> thread, NULL, serverThread, server);
+    pthread_sigmask(SIG_SETMASK, &previousSignals, NULL);
+    if(result != 0) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to start server thread: %s", strerror(result));
+        transportServerStop(server);
+        return NULL;
+    }
+    server -> threadStarted = true;
+
+    return server;
+}
+
+void transportServerStop(transport_server_t *server) {
+    if(server == NULL) {
+        return;
+    }
+
+    if(server -> threadStarted) {
+        __atomic_store_n(&server -> stop, true, __ATOMIC_RELEASE);
+        uint64_t value = 1;
+        if(write(server -> wakeFd, &value, sizeof(value)) == -1) {
+            fprintf(stderr, "[transport] WARNING: Failed to wake server thread: %s\n", strerror(errno));
+        }
+        pthread_join(server -> thread, NULL);
+    }
+
+    // Generators that did not receive the whole graph yet notice the closed connection instead
+    uint8_t stopFrame[FRAME_HEADER_SIZE];
+    putHeader(stopFrame, 0, FRAME_STOP);
+    for(int i = 0; i < TRANSPORT_MAX_CONNECTIONS; ++i) {
+        connection_t *connection = &server -> connections[i];
+        if(connection -> fd != -1 && connection -> outputSent == sizeof(connection -> hello) + server -> edgePayloadSize) {
+            if(send(connection -> fd, stopFrame, sizeof(stopFrame), MSG_NOSIGNAL | MSG_DONTWAIT) == -1) {
+                fprintf(stderr, "[transport] WARNING: Failed to send stop frame: %s\n", strerror(errno));
+            }
+        }
+        closeConnection(server, i);
+        free(connection -> input);
+    }
+
+    if(server -> listenFd != -1) {
+        close(server -> listenFd);
+    }
+    if(server -> epollFd != -1) {
+        close(server -> epollFd);
+    }
+    if(server -> wakeFd != -1) {
+        close(server -> wakeFd);
+    }
+    free(server -> edgePayload);
+    free(server);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Client
+
+/**
+ * @brief Receives exactly size bytes
+ *
+ * @return 0 on success, -1 if the connection failed or was closed
+ */
+static int receiveAll(int fd, uint8_t *buffer, size_t size) {
+    while(size > 0) {
+        ssize_t received = recv(fd, buffer, size, 0);
+        if(received == 0) {
+            errno = ECONNRESET;
+            return -1;
+        }
+        if(received == -1) {
+            return -1;
+        }
+        buffer += received;
+        size -= received;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sends exactly size bytes
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int sendAll(int fd, const uint8_t *buffer, size_t size) {
+    while(size > 0) {
+        ssize_t sent = send(fd, buffer, size, MSG_NOSIGNAL);
+        if(sent == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buffer += sent;
+        size -= sent;
+    }
+    return 0;
+}
+
+int transportConnect(const char *address, char *error) {
+    char host[256];
+    error[0] = '\0';
+    const char *separator = strrchr(address, ':');
+    if(separator == NULL || separator == address || (size_t) (separator - address) >= sizeof(host) || separator[1] == '\0') {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Invalid address %s, expected {host}:{port}", address);
+        return -1;
+    }
+    memcpy(host, address, separator - address);
+    host[separator - address] = '\0';
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *addresses;
+    int result = getaddrinfo(host, separator + 1, &hints, &addresses);
+    if(result != 0) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to resolve %s: %s", address, gai_strerror(result));
+        return -1;
+    }
+
+    int fd = -1;
+    for(struct addrinfo *current = addresses; current != NULL && fd == -1; current = current -> ai_next) {
+        if((fd = socket(current -> ai_family, current -> ai_socktype | SOCK_CLOEXEC, current -> ai_protocol)) == -1) {
+            continue;
+        }
+        if(connect(fd, current -> ai_addr, current -> ai_addrlen) == -1) {
+            snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to connect to %s: %s", address, strerror(errno));
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if(fd == -1) {
+        if(error[0] == '\0') {
+            snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to connect to %s", address);
+        }
+        return -1;
+    }
+
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return fd;
+}
+
+int transportReceiveGraph(int fd, transport_hello_t *hello, graph_t *graph, char *error) {
+    uint8_t header[FRAME_HEADER_SIZE + GRAPH_HELLO_SIZE];
+    if(receiveAll(fd, header, sizeof(header)) == -1) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to receive graph: %s", strerror(errno));
+        return -1;
+    }
+    if(getU32(header + 4) != FRAME_GRAPH) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Expected a graph frame but received type %u", getU32(header + 4));
+        return -1;
+    }
+
+    hello -> numColors = (int) getU32(header + 8);
+    hello -> strategy = (int) getU32(header + 12);
+    hello -> strategyConfig.restartInterval = (long) getU64(header + 16);
+    hello -> strategyConfig.samplingBias = (int) getU32(header + 24);
+    hello -> strategyConfig.seedStream = (int) getU32(header + 28);
+    uint64_t numEdges = getU64(header + 32);
+    hello -> strategyConfig.construction = (int) getU32(header + 40);
+    // The edge count comes from the peer, it is bounded before it is multiplied with anything
+    if(numEdges > (UINT32_MAX - GRAPH_HELLO_SIZE) / GRAPH_EDGE_SIZE || numEdges > SIZE_MAX / sizeof(long[2]) ||
+        getU32(header) != GRAPH_HELLO_SIZE + numEdges * GRAPH_EDGE_SIZE) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Graph frame size does not match its %llu edges", (unsigned long long) numEdges);
+        return -1;
+    }
+
+    long (*edgeList)[2] = malloc(sizeof(long[2]) * (numEdges > 0 ? numEdges : 1));
+    uint8_t *chunk = malloc(RECEIVE_CHUNK_EDGES * GRAPH_EDGE_SIZE);
+    if(edgeList == NULL || chunk == NULL) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to allocate edges: %s", strerror(errno));
+        free(edgeList);
+        free(chunk);
+        return -1;
+    }
+
+    for(uint64_t received = 0; received < numEdges;) {
+        size_t count = numEdges - received < RECEIVE_CHUNK_EDGES ? numEdges - received : RECEIVE_CHUNK_EDGES;
+        if(receiveAll(fd, chunk, count * GRAPH_EDGE_SIZE) == -1) {
+            snprintf(error, TRANSPORT_ERROR_SIZE, "Failed to receive edges: %s", strerror(errno));
+            free(edgeList);
+            free(chunk);
+            return -1;
+        }
+        for(size_t i = 0; i < count; ++i) {
+            edgeList[received + i][0] = (long) getU64(chunk + i * GRAPH_EDGE_SIZE);
+            edgeList[received + i][1] = (long) getU64(chunk + i * GRAPH_EDGE_SIZE + 8);
+        }
+        received += count;
+    }
+    free(chunk);
+
+    char graphError[GRAPH_ERROR_SIZE];
+    int result = graphFromEdgeList(graph, (const long (*)[2]) edgeList, numEdges, graphError);
+    free(edgeList);
+    if(result == -1) {
+        snprintf(error, TRANSPORT_ERROR_SIZE, "Received an invalid graph: %.200s", graphError);
+        return -1;
+    }
+    return 0;
+}
+
+int transportSendResult(int fd, const long (*edges)[2], size_t numEdges, int strategy, int verdict) {
+    uint8_t frame[FRAME_HEADER_SIZE + RESULT_MAX_PAYLOAD];
+    if(numEdges > MAX_NUM_EDGES_RESULT_SET) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    uint32_t payloadSize = (uint32_t) (RESULT_FIXED_SIZE + numEdges * GRAPH_EDGE_SIZE);
+    putHeader(frame, payloadSize, FRAME_RESULT);
+    putU32(frame + FRAME_HEADER_SIZE, (uint32_t) strategy);
+    putU32(frame + FRAME_HEADER_SIZE + 4, (uint32_t) numEdges);
+    putU32(frame + FRAME_HEADER_SIZE + 8, (uint32_t) verdict);
+    for(size_t i = 0; i < numEdges; ++i) {
+        putU64(frame + FRAME_HEADER_SIZE + RESULT_FIXED_SIZE + i * GRAPH_EDGE_SIZE, (uint64_t) edges[i][0]);
+        putU64(frame + FRAME_HEADER_SIZE + RESULT_FIXED_SIZE + i * GRAPH_EDGE_SIZE + 8, (uint64_t) edges[i][1]);
+    }
+
+    return sendAll(fd, frame, FRAME_HEADER_SIZE + payloadSize);
+}
+
+int transportSendColoring(int fd, const uint8_t *packedColors, size_t numNodes, int strategy) {
+    uint8_t header[FRAME_HEADER_SIZE + COLORING_FIXED_SIZE];
+    size_t packedSize = (numNodes + 3) / 4;
+    if(COLORING_FIXED_SIZE + packedSize > UINT32_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    putHeader(header, (uint32_t) (COLORING_FIXED_SIZE + packedSize), FRAME_COLORING);
+    putU32(header + FRAME_HEADER_SIZE, (uint32_t) strategy);
+    if(sendAll(fd, header, sizeof(header)) == -1) {
+        return -1;
+    }
+    return sendAll(fd, packedColors, packedSize);
+}
+
+bool transportStopRequested(int fd) {
+    // The supervisor sends nothing but the stop frame after the graph
+    uint8_t byte;
+    ssize_t received = recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if(received == -1) {
+        return errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+    }
+    return true;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file transport.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the TCP transport between the supervisor and remote generators
+ * @details Every message is a frame of an 8 byte header (payload length and frame type, both big endian) and a payload.
+ *          The supervisor sends one graph frame per connection, the generator streams result frames back
+ *          and the supervisor ends the search with a stop frame. A generator that found a coloring sends the coloring
+ *          itself instead of a result without edges, and the server checks it against the graph before passing it on.
+ *
+ **/
+
+#ifndef TRANSPORT_H_FILE
+#define TRANSPORT_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "commons.h"
+#include "graph.h"
+
+#define TRANSPORT_ERROR_SIZE 256
+#define TRANSPORT_MAX_CONNECTIONS 256
+
+#define FRAME_HEADER_SIZE 8
+#define FRAME_GRAPH 1
+#define FRAME_RESULT 2
+#define FRAME_STOP 3
+#define FRAME_COLORING 4
+
+/**
+ * @brief Everything a remote generator receives besides the edges when it connects
+ *
+ */
+typedef struct {
+    int numColors;
+    int strategy;
+    strategy_config_t strategyConfig;
+} transport_hello_t;
+
+/**
+ * @brief A result received from a remote generator
+ *
+ */
+typedef struct {
+    int connection;
+    int strategy;
+    int verdict;
+    size_t numEdges;
+    long edges[MAX_NUM_EDGES_RESULT_SET][2];
+} transport_result_t;
+
+/**
+ * @brief Callback the server calls from its thread for every received result. It must not block, a result it cannot
+ *        take right now is offered again after a short while and the connection is not read until then
+ *
+ * @return false if the result could not be taken
+ */
+typedef bool (*transport_result_callback_t)(void *context, const transport_result_t *result);
+
+typedef struct transport_server transport_server_t;
+
+/**
+ * @brief Starts a thread that accepts remote generators on the given port, sends each of them the graph
+ *        and passes their results to onResult. All sockets are non-blocking and multiplexed with epoll.
+ *        Results whose edges are not in the graph and colorings with a monochromatic edge drop the connection,
+ *        a received coloring reaches onResult as a colorable result without edges.
+ *
+ * @param port The TCP port to listen on
+ * @param graph The graph to send, indexed with graphBuildIndex. Has to stay valid until the server is stopped
+ * @param numColors The number of colors the generators should use
+ * @param strategies The strategy portfolio, connections are assigned its entries round robin
+ * @param onResult Callback for received results
+ * @param context Passed to onResult
+ * @param error Buffer of TRANSPORT_ERROR_SIZE bytes for the error message
+ * @return The server or NULL on failure
+ */
+transport_server_t* transportServerStart(int port, const graph_t *graph, int numColors, const strategy_config_t *strategies,
+    transport_result_callback_t onResult, void *context, char *error);
+
+/**
+ * @brief Sends a stop frame to every connected generator, stops the server thread and closes all sockets
+ *
+ * @param server The server to stop, may be NULL
+ */
+void transportServerStop(transport_server_t *server);
+
+/**
+ * @brief Connects to a supervisor
+ *
+ * @param address Address of the form {host}:{port}
+ * @param error Buffer of TRANSPORT_ERROR_SIZE bytes for the error message
+ * @return The connected socket or -1 on failure
+ */
+int transportConnect(const char *address, char *error);
+
+/**
+ * @brief Receives the graph frame the supervisor sends after connecting and builds the graph from it
+ *
+ * @param fd The connected socket
+ * @param hello Output for the search parameters
+ * @param graph The graph to fill
+ * @param error Buffer of TRANSPORT_ERROR_SIZE bytes for the error message
+ * @return 0 on success, -1 on failure
+ */
+int transportReceiveGraph(int fd, transport_hello_t *hello, graph_t *graph, char *error);
+
+/**
+ * @brief Sends a result frame
+ *
+ * @param fd The connected socket
+ * @param edges The edges to remove
+ * @param numEdges Number of edges, 1 to MAX_NUM_EDGES_RESULT_SET. Only a verdict of VERDICT_UNCOLORABLE comes without edges
+ * @param strategy The strategy the result was found with
+ * @param verdict One of the VERDICT_ values
+ * @return 0 on success, -1 with errno set on failure
+ */
+int transportSendResult(int fd, const long (*edges)[2], size_t numEdges, int strategy, int verdict);
+
+/**
+ * @brief Sends a coloring frame, the proof that the graph is colorable
+ *
+ * @param fd The connected socket
+ * @param packedColors Two bits per node in the order of the received graph, node n in bits 2 * (n % 4) of byte n / 4
+ * @param numNodes Number of nodes of the received graph
+ * @param strategy The strategy the coloring was found with
+ * @return 0 on success, -1 with errno set on failure
+ */
+int transportSendColoring(int fd, const uint8_t *packedColors, size_t numNodes, int strategy);
+
+/**
+ * @brief Checks without blocking whether the supervisor asked to stop or closed the connection
+ *
+ * @param fd The connected socket
+ * @return true if the generator should stop
+ */
+bool transportStopRequested(int fd);
+
+#endif
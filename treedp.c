@@ -0,0 +1,876 @@
+/**
+ * @file treedp.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Min-degree tree decomposition and dynamic programming over its bags
+ *
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <pthread.h>
+
+#include "treedp.h"
+
+#define NO_NODE UINT32_MAX
+
+/**
+ * @brief Separators are limited to this size so the neighbors of a node in its separator fit into a bit mask
+ */
+#define MAX_SEPARATOR 31
+
+/**
+ * @brief Number of tasks per thread the subtrees are cut into, so threads that finish early take over the rest
+ */
+#define TASKS_PER_THREAD 8
+
+/**
+ * @brief Below this many bag states in total the tables are computed on the calling thread only
+ */
+#define PARALLEL_MIN_STATES (1UL << 20)
+
+/**
+ * @brief The decomposition, the tables and the task lists of one solve
+ *
+ */
+typedef struct {
+    const graph_adjacency_t *adjacency;
+    int numColors;
+    size_t numNodes;
+    size_t width;
+    size_t maxStates;
+    size_t totalStates;
+    uint32_t *order;
+    uint32_t *rank;
+    uint32_t *parent;
+    size_t *separatorOffsets;
+    uint32_t *separators;
+    size_t *childOffsets;
+    uint32_t *children;
+    size_t *tableOffsets;
+    uint8_t *arena;
+    uint32_t *taskNodes;
+    size_t *taskOffsets;
+    size_t numTasks;
+    size_t nextTask;
+    int error;
+} treedp_t;
+
+/**
+ * @brief Returns the separator of a node and its size
+ */
+static inline const uint32_t* separatorOf(const treedp_t *dp, uint32_t node, size_t *size) {
+    size_t position = dp -> rank[node];
+    *size = dp -> separatorOffsets[position + 1] - dp -> separatorOffsets[position];
+    return &dp -> separators[dp -> separatorOffsets[position]];
+}
+
+/**
+ * @brief Returns numColors to the power of exponent
+ */
+static inline size_t power(const treedp_t *dp, size_t exponent) {
+    size_t result = 1;
+    for(size_t i = 0; i < exponent; ++i) {
+        result *= (size_t) dp -> numColors;
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Elimination
+
+/**
+ * @brief Empty slot of the edge set
+ */
+#define EMPTY_EDGE UINT64_MAX
+
+/**
+ * @brief Neighbor lists of the graph that is eliminated. Every list lives in one pool and moves to the end of it
+ *        with twice the capacity when it is full. Eliminated nodes stay in the lists until they make up half of one.
+ *        The edge set answers whether two nodes are adjacent without scanning the list of a node of high degree
+ *
+ */
+typedef struct {
+    uint32_t *pool;
+    size_t poolSize;
+    size_t poolCapacity;
+    size_t *listStart;
+    uint32_t *listSize;
+    uint32_t *listCapacity;
+    uint32_t *degree;
+    uint32_t *bucketHead;
+    uint32_t *bucketNext;
+    uint32_t *bucketPrev;
+    uint32_t *bucketOf;
+    uint64_t *edgeSet;
+    size_t edgeSetSize;
+    size_t edgeSetCapacity;
+    uint8_t *eliminated;
+} elimination_t;
+
+/**
+ * @brief Removes a node from the bucket of its degree
+ */
+static void bucketRemove(elimination_t *elimination, uint32_t node) {
+    uint32_t next = elimination -> bucketNext[node];
+    uint32_t prev = elimination -> bucketPrev[node];
+    if(prev != NO_NODE) {
+        elimination -> bucketNext[prev] = next;
+    } else {
+        elimination -> bucketHead[elimination -> bucketOf[node]] = next;
+    }
+    if(next != NO_NODE) {
+        elimination -> bucketPrev[next] = prev;
+    }
+}
+
+/**
+ * @brief Puts a node into the bucket of a degree
+ */
+static void bucketInsert(elimination_t *elimination, uint32_t node, uint32_t degree) {
+    elimination -> bucketOf[node] = degree;
+    elimination -> bucketPrev[node] = NO_NODE;
+    elimination -> bucketNext[node] = elimination -> bucketHead[degree];
+    if(elimination -> bucketHead[degree] != NO_NODE) {
+        elimination -> bucketPrev[elimination -> bucketHead[degree]] = node;
+    }
+    elimination -> bucketHead[degree] = node;
+}
+
+/**
+ * @brief Appends a neighbor to the list of a node
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int addNeighbor(elimination_t *elimination, uint32_t node, uint32_t neighbor) {
+    if(elimination -> listSize[node] == elimination -> listCapacity[node]) {
+        size_t capacity = 2 * (size_t) elimination -> listCapacity[node] + 4;
+        if(capacity > UINT32_MAX) {
+            errno = EOVERFLOW;
+            return -1;
+        }
+        if(elimination -> poolSize + capacity > elimination -> poolCapacity) {
+            size_t poolCapacity = 2 * elimination -> poolCapacity + capacity;
+            uint32_t *pool = realloc(elimination -> pool, sizeof(uint32_t) * poolCapacity);
+            if(pool == NULL) {
+                return -1;
+            }
+            elimination -> pool = pool;
+            elimination -> poolCapacity = poolCapacity;
+        }
+        memcpy(&elimination -> pool[elimination -> poolSize], &elimination -> pool[elimination -> listStart[node]], sizeof(uint32_t) * elimination -> listSize[node]);
+        elimination -> listStart[node] = elimination -> poolSize;
+        elimination -> listCapacity[node] = (uint32_t) capacity;
+        elimination -> poolSize += capacity;
+    }
+    elimination -> pool[elimination -> listStart[node] + elimination -> listSize[node]++] = neighbor;
+    return 0;
+}
+
+/**
+ * @brief Drops the eliminated nodes from the list of a node once they are the majority
+ */
+static void compactList(elimination_t *elimination, uint32_t node) {
+    if(elimination -> listSize[node] <= 2 * elimination -> degree[node] + 8) {
+        return;
+    }
+    uint32_t *list = &elimination -> pool[elimination -> listStart[node]];
+    uint32_t size = 0;
+    for(uint32_t i = 0; i < elimination -> listSize[node]; ++i) {
+        if(!elimination -> eliminated[list[i]]) {
+            list[size++] = list[i];
+        }
+    }
+    elimination -> listSize[node] = size;
+}
+
+/**
+ * @brief Returns the first slot of an edge in the edge set
+ */
+static inline size_t edgeSlot(uint64_t key, size_t capacity) {
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (size_t) (key ^ (key >> 32)) & (capacity - 1);
+}
+
+/**
+ * @brief Returns the key of an edge, the smaller node in the upper half
+ */
+static inline uint64_t edgeKey(uint32_t u, uint32_t v) {
+    return u < v ? (uint64_t) u << 32 | v : (uint64_t) v << 32 | u;
+}
+
+/**
+ * @brief Checks whether two nodes are adjacent
+ */
+static bool hasEdge(const elimination_t *elimination, uint32_t u, uint32_t v) {
+    uint64_t key = edgeKey(u, v);
+    size_t mask = elimination -> edgeSetCapacity - 1;
+    for(size_t slot = edgeSlot(key, elimination -> edgeSetCapacity); elimination -> edgeSet[slot] != EMPTY_EDGE; slot = (slot + 1) & mask) {
+        if(elimination -> edgeSet[slot] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Adds an edge that is not in the edge set yet, doubling the set when it is half full
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int insertEdge(elimination_t *elimination, uint32_t u, uint32_t v) {
+    if(2 * (elimination -> edgeSetSize + 1) > elimination -> edgeSetCapacity) {
+        size_t capacity = 2 * elimination -> edgeSetCapacity;
+        uint64_t *edgeSet = malloc(sizeof(uint64_t) * capacity);
+        if(edgeSet == NULL) {
+            return -1;
+        }
+        memset(edgeSet, 0xFF, sizeof(uint64_t) * capacity);
+        for(size_t i = 0; i < elimination -> edgeSetCapacity; ++i) {
+            uint64_t key = elimination -> edgeSet[i];
+            if(key != EMPTY_EDGE) {
+                size_t slot = edgeSlot(key, capacity);
+                while(edgeSet[slot] != EMPTY_EDGE) {
+                    slot = (slot + 1) & (capacity - 1);
+                }
+                edgeSet[slot] = key;
+            }
+        }
+        free(elimination -> edgeSet);
+        elimination -> edgeSet = edgeSet;
+        elimination -> edgeSetCapacity = capacity;
+    }
+    uint64_t key = edgeKey(u, v);
+    size_t slot = edgeSlot(key, elimination -> edgeSetCapacity);
+    while(elimination -> edgeSet[slot] != EMPTY_EDGE) {
+        slot = (slot + 1) & (elimination -> edgeSetCapacity - 1);
+    }
+    elimination -> edgeSet[slot] = key;
+    ++elimination -> edgeSetSize;
+    return 0;
+}
+
+/**
+ * @brief Frees the neighbor lists and the buckets
+ */
+static void freeElimination(elimination_t *elimination) {
+    free(elimination -> pool);
+    free(elimination -> listStart);
+    free(elimination -> listSize);
+    free(elimination -> listCapacity);
+    free(elimination -> degree);
+    free(elimination -> bucketHead);
+    free(elimination -> bucketNext);
+    free(elimination -> bucketPrev);
+    free(elimination -> bucketOf);
+    free(elimination -> edgeSet);
+    free(elimination -> eliminated);
+}
+
+/**
+ * @brief Peels off nodes with at most limit remaining neighbors until none is left or every remaining node has more.
+ *        The remaining nodes would keep more than limit neighbors in every elimination order, so the width of
+ *        every decomposition is larger than limit
+ *
+ * @return 1 if some nodes remain, 0 if all were peeled off, -1 with errno set on failure
+ */
+static int coreExceeds(const graph_adjacency_t *adjacency, size_t limit) {
+    size_t numNodes = adjacency -> numNodes;
+    uint32_t *degree = malloc(sizeof(uint32_t) * (numNodes > 0 ? numNodes : 1));
+    uint32_t *queue = malloc(sizeof(uint32_t) * (numNodes > 0 ? numNodes : 1));
+    if(degree == NULL || queue == NULL) {
+        free(degree);
+        free(queue);
+        return -1;
+    }
+
+    size_t tail = 0;
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        degree[node] = adjacency -> offsets[node + 1] - adjacency -> offsets[node];
+        if(degree[node] <= limit) {
+            queue[tail++] = node;
+        }
+    }
+    // A node enters the queue once, when its degree drops to limit
+    for(size_t head = 0; head < tail; ++head) {
+        uint32_t node = queue[head];
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            if(degree[adjacency -> neighbors[i]]-- == limit + 1) {
+                queue[tail++] = adjacency -> neighbors[i];
+            }
+        }
+    }
+
+    free(degree);
+    free(queue);
+    return tail < numNodes;
+}
+
+/**
+ * @brief Eliminates the nodes in min-degree order, turning the neighbors of every eliminated node into a clique,
+ *        and records the elimination order and the separator of every node
+ *
+ * @param dp The solve with adjacency, numColors and numNodes set and order, rank and separatorOffsets allocated
+ * @param maxSeparator The elimination gives up once every remaining node has more neighbors than this
+ * @return 1 on success, 0 if the width, the tables or the work got too large, -1 with errno set on failure
+ */
+static int eliminate(treedp_t *dp, size_t maxSeparator) {
+    const graph_adjacency_t *adjacency = dp -> adjacency;
+    size_t numNodes = dp -> numNodes;
+    size_t numEntries = adjacency -> offsets[numNodes];
+    elimination_t elimination;
+    memset(&elimination, 0, sizeof(elimination));
+    elimination.poolCapacity = numEntries + numNodes + 1;
+    elimination.pool = malloc(sizeof(uint32_t) * elimination.poolCapacity);
+    elimination.listStart = malloc(sizeof(size_t) * numNodes);
+    elimination.listSize = malloc(sizeof(uint32_t) * numNodes);
+    elimination.listCapacity = malloc(sizeof(uint32_t) * numNodes);
+    elimination.degree = malloc(sizeof(uint32_t) * numNodes);
+    elimination.bucketHead = malloc(sizeof(uint32_t) * (numNodes + 1));
+    elimination.bucketNext = malloc(sizeof(uint32_t) * numNodes);
+    elimination.bucketPrev = malloc(sizeof(uint32_t) * numNodes);
+    elimination.bucketOf = malloc(sizeof(uint32_t) * numNodes);
+    elimination.edgeSetCapacity = 4;
+    while(elimination.edgeSetCapacity < numEntries + 2) {
+        elimination.edgeSetCapacity *= 2;
+    }
+    elimination.edgeSet = malloc(sizeof(uint64_t) * elimination.edgeSetCapacity);
+    elimination.eliminated = calloc(numNodes, 1);
+    size_t separatorCapacity = numNodes + 1;
+    dp -> separators = malloc(sizeof(uint32_t) * separatorCapacity);
+    if(elimination.pool == NULL || elimination.listStart == NULL || elimination.listSize == NULL || elimination.listCapacity == NULL ||
+        elimination.degree == NULL || elimination.bucketHead == NULL || elimination.bucketNext == NULL || elimination.bucketPrev == NULL ||
+        elimination.bucketOf == NULL || elimination.edgeSet == NULL || elimination.eliminated == NULL || dp -> separators == NULL) {
+        freeElimination(&elimination);
+        return -1;
+    }
+
+    memcpy(elimination.pool, adjacency -> neighbors, sizeof(uint32_t) * numEntries);
+    memset(elimination.edgeSet, 0xFF, sizeof(uint64_t) * elimination.edgeSetCapacity);
+    elimination.poolSize = numEntries;
+    for(size_t degree = 0; degree <= numNodes; ++degree) {
+        elimination.bucketHead[degree] = NO_NODE;
+    }
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        elimination.listStart[node] = adjacency -> offsets[node];
+        elimination.listSize[node] = adjacency -> offsets[node + 1] - adjacency -> offsets[node];
+        elimination.listCapacity[node] = elimination.listSize[node];
+        elimination.degree[node] = elimination.listSize[node];
+        bucketInsert(&elimination, node, elimination.degree[node]);
+        // The edge set is sized for the edges of the graph, so these insertions never grow it
+        for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+            if(node < adjacency -> neighbors[i]) {
+                insertEdge(&elimination, node, adjacency -> neighbors[i]);
+            }
+        }
+    }
+
+    size_t budget = TREEDP_ELIMINATION_WORK_FACTOR * (numNodes + numEntries);
+    size_t work = 0;
+    size_t arenaSize = 0;
+    size_t numSeparators = 0;
+    uint32_t minDegree = 0;
+    int result = 1;
+    dp -> separatorOffsets[0] = 0;
+    for(size_t position = 0; position < numNodes && result == 1; ++position) {
+        while(elimination.bucketHead[minDegree] == NO_NODE) {
+            ++minDegree;
+        }
+        if(minDegree > maxSeparator) {
+            result = 0;
+            break;
+        }
+        uint32_t node = elimination.bucketHead[minDegree];
+        bucketRemove(&elimination, node);
+        elimination.eliminated[node] = 1;
+        dp -> rank[node] = (uint32_t) position;
+        dp -> order[position] = node;
+
+        // The remaining neighbors are the separator of the node
+        if(numSeparators + minDegree > separatorCapacity) {
+            separatorCapacity = 2 * separatorCapacity + minDegree;
+            uint32_t *separators = realloc(dp -> separators, sizeof(uint32_t) * separatorCapacity);
+            if(separators == NULL) {
+                result = -1;
+                break;
+            }
+            dp -> separators = separators;
+        }
+        uint32_t *separator = &dp -> separators[numSeparators];
+        size_t size = 0;
+        const uint32_t *list = &elimination.pool[elimination.listStart[node]];
+        for(uint32_t i = 0; i < elimination.listSize[node]; ++i) {
+            if(!elimination.eliminated[list[i]]) {
+                separator[size++] = list[i];
+            }
+        }
+        work += elimination.listSize[node];
+        numSeparators += size;
+        dp -> separatorOffsets[position + 1] = numSeparators;
+        if(size > dp -> width) {
+            dp -> width = size;
+        }
+        arenaSize += power(dp, size);
+
+        // The separator becomes a clique
+        for(size_t i = 0; i < size; ++i) {
+            --elimination.degree[separator[i]];
+        }
+        work += size * size;
+        for(size_t i = 0; i < size && result == 1; ++i) {
+            for(size_t j = i + 1; j < size; ++j) {
+                if(hasEdge(&elimination, separator[i], separator[j])) {
+                    continue;
+                }
+                if(insertEdge(&elimination, separator[i], separator[j]) == -1 ||
+                    addNeighbor(&elimination, separator[i], separator[j]) == -1 || addNeighbor(&elimination, separator[j], separator[i]) == -1) {
+                    result = -1;
+                    break;
+                }
+                ++elimination.degree[separator[i]];
+                ++elimination.degree[separator[j]];
+            }
+        }
+        for(size_t i = 0; i < size; ++i) {
+            uint32_t neighbor = separator[i];
+            compactList(&elimination, neighbor);
+            bucketRemove(&elimination, neighbor);
+            bucketInsert(&elimination, neighbor, elimination.degree[neighbor]);
+            if(elimination.degree[neighbor] < minDegree) {
+                minDegree = elimination.degree[neighbor];
+            }
+        }
+        if((work > budget || arenaSize > TREEDP_MAX_ARENA) && result == 1) {
+            result = 0;
+        }
+    }
+
+    freeElimination(&elimination);
+    return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Tree
+
+/**
+ * @brief Links every bag to the bag of its earliest eliminated separator node and allocates the arena of the tables
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int buildTree(treedp_t *dp) {
+    size_t numNodes = dp -> numNodes;
+    dp -> parent = malloc(sizeof(uint32_t) * numNodes);
+    dp -> childOffsets = calloc(numNodes + 1, sizeof(size_t));
+    dp -> children = malloc(sizeof(uint32_t) * (numNodes > 0 ? numNodes : 1));
+    dp -> tableOffsets = malloc(sizeof(size_t) * numNodes);
+    if(dp -> parent == NULL || dp -> childOffsets == NULL || dp -> children == NULL || dp -> tableOffsets == NULL) {
+        return -1;
+    }
+
+    size_t arenaSize = 0;
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        size_t size;
+        const uint32_t *separator = separatorOf(dp, node, &size);
+        dp -> parent[node] = NO_NODE;
+        for(size_t i = 0; i < size; ++i) {
+            if(dp -> parent[node] == NO_NODE || dp -> rank[separator[i]] < dp -> rank[dp -> parent[node]]) {
+                dp -> parent[node] = separator[i];
+            }
+        }
+        if(dp -> parent[node] != NO_NODE) {
+            ++dp -> childOffsets[dp -> parent[node] + 1];
+        }
+        dp -> tableOffsets[node] = arenaSize;
+        arenaSize += power(dp, size);
+    }
+
+    for(size_t node = 0; node < numNodes; ++node) {
+        dp -> childOffsets[node + 1] += dp -> childOffsets[node];
+    }
+    // Fill every list from its start, which moves every offset to the start of the next list
+    for(uint32_t node = 0; node < numNodes; ++node) {
+        if(dp -> parent[node] != NO_NODE) {
+            dp -> children[dp -> childOffsets[dp -> parent[node]]++] = node;
+        }
+    }
+    for(size_t node = numNodes; node > 0; --node) {
+        dp -> childOffsets[node] = dp -> childOffsets[node - 1];
+    }
+    dp -> childOffsets[0] = 0;
+
+    if((dp -> arena = malloc(arenaSize > 0 ? arenaSize : 1)) == NULL) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Cuts the tree into tasks. Every maximal subtree with at most a share of the total work becomes one task with
+ *        its bags in elimination order, the bags above them stay with the calling thread
+ *
+ * @param dp The solve
+ * @param numThreads The number of threads
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int buildTasks(treedp_t *dp, int numThreads) {
+    size_t numNodes = dp -> numNodes;
+    size_t *subtreeStates = calloc(numNodes, sizeof(size_t));
+    uint32_t *taskOf = malloc(sizeof(uint32_t) * numNodes);
+    dp -> taskNodes = malloc(sizeof(uint32_t) * numNodes);
+    dp -> taskOffsets = calloc(numNodes + 1, sizeof(size_t));
+    if(subtreeStates == NULL || taskOf == NULL || dp -> taskNodes == NULL || dp -> taskOffsets == NULL) {
+        free(subtreeStates);
+        free(taskOf);
+        return -1;
+    }
+
+    // Children come before their parent in elimination order
+    dp -> totalStates = 0;
+    for(size_t position = 0; position < numNodes; ++position) {
+        uint32_t node = dp -> order[position];
+        size_t size;
+        separatorOf(dp, node, &size);
+        subtreeStates[node] += power(dp, size + 1);
+        dp -> totalStates += power(dp, size + 1);
+        if(dp -> parent[node] != NO_NODE) {
+            subtreeStates[dp -> parent[node]] += subtreeStates[node];
+        }
+    }
+
+    size_t threshold = dp -> totalStates / ((size_t) TASKS_PER_THREAD * (size_t) numThreads) + 1;
+    dp -> numTasks = 0;
+    for(size_t position = numNodes; position > 0; --position) {
+        uint32_t node = dp -> order[position - 1];
+        uint32_t parent = dp -> parent[node];
+        if(subtreeStates[node] > threshold) {
+            taskOf[node] = NO_NODE;
+        } else if(parent != NO_NODE && taskOf[parent] != NO_NODE) {
+            taskOf[node] = taskOf[parent];
+        } else {
+            taskOf[node] = (uint32_t) dp -> numTasks++;
+        }
+        if(taskOf[node] != NO_NODE) {
+            ++dp -> taskOffsets[taskOf[node] + 1];
+        }
+    }
+    for(size_t task = 0; task < dp -> numTasks; ++task) {
+        dp -> taskOffsets[task + 1] += dp -> taskOffsets[task];
+    }
+    for(size_t position = 0; position < numNodes; ++position) {
+        uint32_t node = dp -> order[position];
+        if(taskOf[node] != NO_NODE) {
+            dp -> taskNodes[dp -> taskOffsets[taskOf[node]]++] = node;
+        }
+    }
+    for(size_t task = dp -> numTasks; task > 0; --task) {
+        dp -> taskOffsets[task] = dp -> taskOffsets[task - 1];
+    }
+    dp -> taskOffsets[0] = 0;
+
+    // The bags above the tasks follow the last task
+    size_t next = dp -> taskOffsets[dp -> numTasks];
+    for(size_t position = 0; position < numNodes; ++position) {
+        uint32_t node = dp -> order[position];
+        if(taskOf[node] == NO_NODE) {
+            dp -> taskNodes[next++] = node;
+        }
+    }
+
+    free(subtreeStates);
+    free(taskOf);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Tables
+
+/**
+ * @brief Returns the bit mask of the separator positions that are original neighbors of a node
+ */
+static uint32_t originalNeighborMask(const treedp_t *dp, uint32_t node, const uint32_t *separator, size_t size) {
+    const graph_adjacency_t *adjacency = dp -> adjacency;
+    uint32_t mask = 0;
+    for(uint32_t i = adjacency -> offsets[node]; i < adjacency -> offsets[node + 1]; ++i) {
+        uint32_t neighbor = adjacency -> neighbors[i];
+        if(dp -> rank[neighbor] < dp -> rank[node]) {
+            continue;
+        }
+        for(size_t j = 0; j < size; ++j) {
+            if(separator[j] == neighbor) {
+                mask |= 1u << j;
+                break;
+            }
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief Maps every separator node of a child to its digit in the bag of the parent, digit 0 is the parent node itself
+ */
+static void mapChildSeparator(const uint32_t *childSeparator, size_t childSize, uint32_t node, const uint32_t *separator, size_t size, uint8_t *map) {
+    for(size_t i = 0; i < childSize; ++i) {
+        map[i] = 0;
+        if(childSeparator[i] == node) {
+            continue;
+        }
+        for(size_t j = 0; j < size; ++j) {
+            if(separator[j] == childSeparator[i]) {
+                map[i] = (uint8_t) (j + 1);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Computes the table of a bag from the tables of its children. The states of the bag are the colorings of the
+ *        node (digit 0) and its separator (digits 1 to size), enumerated with an odometer
+ *
+ * @param dp The solve
+ * @param node The node of the bag
+ * @param feasible Scratch buffer for maxStates entries
+ */
+static void computeTable(treedp_t *dp, uint32_t node, uint8_t *feasible) {
+    size_t k = (size_t) dp -> numColors;
+    size_t size;
+    const uint32_t *separator = separatorOf(dp, node, &size);
+    size_t states = power(dp, size + 1);
+    uint32_t mask = originalNeighborMask(dp, node, separator, size);
+    uint8_t digits[MAX_SEPARATOR + 2];
+
+    // The node has to differ from its original neighbors in the separator
+    memset(digits, 0, sizeof(digits));
+    for(size_t state = 0; state < states; ++state) {
+        uint8_t ok = 1;
+        for(uint32_t bits = mask; bits != 0; bits &= bits - 1) {
+            if(digits[1 + __builtin_ctz(bits)] == digits[0]) {
+                ok = 0;
+                break;
+            }
+        }
+        feasible[state] = ok;
+        for(size_t digit = 0; digit <= size && ++digits[digit] == k; ++digit) {
+            digits[digit] = 0;
+        }
+    }
+
+    // and the coloring has to extend to the subtree of every child
+    for(size_t c = dp -> childOffsets[node]; c < dp -> childOffsets[node + 1]; ++c) {
+        uint32_t child = dp -> children[c];
+        size_t childSize;
+        const uint32_t *childSeparator = separatorOf(dp, child, &childSize);
+        const uint8_t *childTable = &dp -> arena[dp -> tableOffsets[child]];
+        uint8_t map[MAX_SEPARATOR + 1];
+        mapChildSeparator(childSeparator, childSize, node, separator, size, map);
+
+        memset(digits, 0, sizeof(digits));
+        for(size_t state = 0; state < states; ++state) {
+            if(feasible[state]) {
+                size_t index = 0;
+                for(size_t i = childSize; i > 0; --i) {
+                    index = index * k + digits[map[i - 1]];
+                }
+                feasible[state] = childTable[index];
+            }
+            for(size_t digit = 0; digit <= size && ++digits[digit] == k; ++digit) {
+                digits[digit] = 0;
+            }
+        }
+    }
+
+    uint8_t *table = &dp -> arena[dp -> tableOffsets[node]];
+    for(size_t coloring = 0; coloring < states / k; ++coloring) {
+        uint8_t any = 0;
+        for(size_t color = 0; color < k; ++color) {
+            any |= feasible[coloring * k + color];
+        }
+        table[coloring] = any;
+    }
+}
+
+/**
+ * @brief Computes the tables of the tasks until none is left
+ */
+static void* runTasks(void *argument) {
+    treedp_t *dp = argument;
+    uint8_t *feasible = malloc(dp -> maxStates);
+    if(feasible == NULL) {
+        __atomic_store_n(&dp -> error, ENOMEM, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    for(;;) {
+        size_t task = __atomic_fetch_add(&dp -> nextTask, 1, __ATOMIC_RELAXED);
+        if(task >= dp -> numTasks) {
+            break;
+        }
+        for(size_t i = dp -> taskOffsets[task]; i < dp -> taskOffsets[task + 1]; ++i) {
+            computeTable(dp, dp -> taskNodes[i], feasible);
+        }
+    }
+    free(feasible);
+    return NULL;
+}
+
+/**
+ * @brief Computes all tables, the tasks on all threads and the bags above them on the calling thread
+ *
+ * @return 0 on success, -1 with errno set on failure
+ */
+static int computeTables(treedp_t *dp, int numThreads) {
+    if(buildTasks(dp, numThreads) == -1) {
+        return -1;
+    }
+
+    // Signals have to reach the main thread
+    pthread_t threads[TREEDP_MAX_THREADS];
+    int numStarted = 0;
+    sigset_t allSignals;
+    sigset_t previousSignals;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousSignals);
+    for(int i = 1; i < numThreads && dp -> numTasks > 1 && dp -> totalStates >= PARALLEL_MIN_STATES; ++i) {
+        if(pthread_create(&threads[numStarted], NULL, runTasks, dp) == 0) {
+            ++numStarted;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &previousSignals, NULL);
+
+    runTasks(dp);
+    for(int i = 0; i < numStarted; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    if(dp -> error != 0) {
+        errno = dp -> error;
+        return -1;
+    }
+
+    uint8_t *feasible = malloc(dp -> maxStates);
+    if(feasible == NULL) {
+        return -1;
+    }
+    for(size_t i = dp -> taskOffsets[dp -> numTasks]; i < dp -> numNodes; ++i) {
+        computeTable(dp, dp -> taskNodes[i], feasible);
+    }
+    free(feasible);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Solve
+
+/**
+ * @brief Colors the nodes from the roots down, every node takes the first color its tables allow for the colors of its
+ *        separator, which were all chosen before
+ *
+ * @return VERDICT_COLORABLE, VERDICT_UNCOLORABLE if the table of a root is empty
+ */
+static int reconstructColoring(const treedp_t *dp, int8_t *colors) {
+    size_t k = (size_t) dp -> numColors;
+    for(uint32_t node = 0; node < dp -> numNodes; ++node) {
+        if(dp -> parent[node] == NO_NODE && dp -> arena[dp -> tableOffsets[node]] == 0) {
+            return VERDICT_UNCOLORABLE;
+        }
+    }
+
+    for(size_t position = dp -> numNodes; position > 0; --position) {
+        uint32_t node = dp -> order[position - 1];
+        size_t size;
+        const uint32_t *separator = separatorOf(dp, node, &size);
+        uint32_t mask = originalNeighborMask(dp, node, separator, size);
+        uint8_t digits[MAX_SEPARATOR + 2];
+        for(size_t j = 0; j < size; ++j) {
+            digits[j + 1] = (uint8_t) colors[separator[j]];
+        }
+
+        colors[node] = -1;
+        for(size_t color = 0; color < k && colors[node] < 0; ++color) {
+            digits[0] = (uint8_t) color;
+            bool ok = true;
+            for(uint32_t bits = mask; bits != 0 && ok; bits &= bits - 1) {
+                ok = digits[1 + __builtin_ctz(bits)] != color;
+            }
+            for(size_t c = dp -> childOffsets[node]; c < dp -> childOffsets[node + 1] && ok; ++c) {
+                uint32_t child = dp -> children[c];
+                size_t childSize;
+                const uint32_t *childSeparator = separatorOf(dp, child, &childSize);
+                uint8_t map[MAX_SEPARATOR + 1];
+                mapChildSeparator(childSeparator, childSize, node, separator, size, map);
+                size_t index = 0;
+                for(size_t i = childSize; i > 0; --i) {
+                    index = index * k + digits[map[i - 1]];
+                }
+                ok = dp -> arena[dp -> tableOffsets[child] + index] != 0;
+            }
+            if(ok) {
+                colors[node] = (int8_t) color;
+            }
+        }
+    }
+    return VERDICT_COLORABLE;
+}
+
+/**
+ * @brief Frees everything of a solve
+ */
+static void freeTreeDp(treedp_t *dp) {
+    free(dp -> order);
+    free(dp -> rank);
+    free(dp -> parent);
+    free(dp -> separatorOffsets);
+    free(dp -> separators);
+    free(dp -> childOffsets);
+    free(dp -> children);
+    free(dp -> tableOffsets);
+    free(dp -> arena);
+    free(dp -> taskNodes);
+    free(dp -> taskOffsets);
+}
+
+int treeDpSolve(const graph_adjacency_t *adjacency, int numColors, int numThreads, int8_t *colors, size_t *width) {
+    treedp_t dp;
+    memset(&dp, 0, sizeof(dp));
+    dp.adjacency = adjacency;
+    dp.numColors = numColors;
+    dp.numNodes = adjacency -> numNodes;
+    numThreads = numThreads < 1 ? 1 : numThreads > TREEDP_MAX_THREADS ? TREEDP_MAX_THREADS : numThreads;
+    *width = 0;
+    if(numColors < 1 || dp.numNodes >= NO_NODE) {
+        return VERDICT_UNKNOWN;
+    }
+
+    // The largest separator whose bag still fits into the state limit
+    size_t maxSeparator = 0;
+    for(size_t states = (size_t) numColors; maxSeparator < MAX_SEPARATOR && states * (size_t) numColors <= TREEDP_MAX_BAG_STATES; states *= (size_t) numColors) {
+        ++maxSeparator;
+    }
+
+    dp.order = malloc(sizeof(uint32_t) * (dp.numNodes > 0 ? dp.numNodes : 1));
+    dp.rank = malloc(sizeof(uint32_t) * (dp.numNodes > 0 ? dp.numNodes : 1));
+    dp.separatorOffsets = malloc(sizeof(size_t) * (dp.numNodes + 1));
+    if(dp.order == NULL || dp.rank == NULL || dp.separatorOffsets == NULL) {
+        freeTreeDp(&dp);
+        return -1;
+    }
+
+    int result = coreExceeds(adjacency, maxSeparator);
+    result = result == 0 ? eliminate(&dp, maxSeparator) : result == 1 ? 0 : -1;
+    if(result == 1) {
+        dp.maxStates = power(&dp, dp.width + 1);
+        result = buildTree(&dp) == 0 ? 1 : -1;
+    }
+    if(result == 1) {
+        result = computeTables(&dp, numThreads) == 0 ? 1 : -1;
+    }
+    int verdict = result == 1 ? reconstructColoring(&dp, colors) : result == 0 ? VERDICT_UNKNOWN : -1;
+    int error = errno;
+    *width = dp.width;
+    freeTreeDp(&dp);
+    errno = error;
+    return verdict;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file treedp.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the exact solver over a tree decomposition of graphs of small treewidth
+ * @details Nodes are eliminated in min-degree order. The bag of a node is the node and its separator, the neighbors
+ *          it still has when it is eliminated, and the parent of the bag is the bag of the separator node eliminated
+ *          first. For every bag the dynamic programming computes a table over the colorings of the separator that tells
+ *          whether the subtree below extends it, by trying every color of the node against the original edges to the
+ *          separator and the tables of the children. All tables live in one arena. Subtrees below a work threshold are
+ *          independent tasks for the worker threads, the bags above them follow on the calling thread, and a coloring
+ *          is read back from the tables from the roots down. Graphs that keep a core of nodes with too many neighbors
+ *          for the largest bag are rejected before the elimination starts.
+ *
+ **/
+
+#ifndef TREEDP_H_FILE
+#define TREEDP_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "commons.h"
+#include "graph.h"
+
+/**
+ * @brief Largest number of entries a bag may enumerate, numColors to the power of the bag size
+ */
+#define TREEDP_MAX_BAG_STATES (1UL << 21)
+
+/**
+ * @brief Largest arena of all separator tables in bytes
+ */
+#define TREEDP_MAX_ARENA (1UL << 27)
+
+/**
+ * @brief The elimination gives up after this many list entries per node and edge were scanned
+ */
+#define TREEDP_ELIMINATION_WORK_FACTOR 64
+
+/**
+ * @brief Largest number of threads computing the tables
+ */
+#define TREEDP_MAX_THREADS 16
+
+/**
+ * @brief Colors a graph or proves that it has no coloring if its min-degree elimination has a small enough width
+ *
+ * @param adjacency The adjacency of the graph
+ * @param numColors The number of colors
+ * @param numThreads The number of threads for the tables, 1 to TREEDP_MAX_THREADS
+ * @param colors Output for the color of every node if the graph is colorable
+ * @param width Output for the width of the decomposition, the size of its largest separator
+ * @return One of the VERDICT_ values, VERDICT_UNKNOWN if the width is too large, -1 with errno set on failure
+ */
+int treeDpSolve(const graph_adjacency_t *adjacency, int numColors, int numThreads, int8_t *colors, size_t *width);
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ * @file weights.c
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Conflict counting, publication and lookup of the shared edge weights
+ *
+ **/
+
+#include <string.h>
+
+#include "weights.h"
+
+/**
+ * @brief Returns the first slot of the probe sequence of an edge, the smaller id has to come first
+ */
+static size_t firstSlot(long u, long v) {
+    uint64_t z = ((uint64_t) u * 0x9E3779B97F4A7C15ULL) ^ (uint64_t) v;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (size_t) ((z ^ (z >> 31)) & (EDGE_WEIGHT_TABLE_SIZE - 1));
+}
+
+void weightsReset(edge_weight_counts_t *counts, edge_weight_table_t *table) {
+    memset(counts -> counts, 0, sizeof(counts -> counts));
+    counts -> used = 0;
+
+    // The generators may be copying, so the table is cleared like a publication
+    uint64_t sequence = table -> sequence;
+    __atomic_store_n(&table -> sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for(size_t slot = 0; slot < EDGE_WEIGHT_TABLE_SIZE; ++slot) {
+        counts -> nodes[slot][0] = -1;
+        counts -> nodes[slot][1] = -1;
+        __atomic_store_n(&table -> entries[slot].nodes[0], -1, __ATOMIC_RELAXED);
+        __atomic_store_n(&table -> entries[slot].nodes[1], -1, __ATOMIC_RELAXED);
+        __atomic_store_n(&table -> entries[slot].weight, 1, __ATOMIC_RELAXED);
+    }
+
+    // A table that was never published stays unpublished, otherwise the generators copy the cleared weights
+    __atomic_store_n(&table -> sequence, sequence == 0 ? 0 : sequence + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Frees the slot of an edge whose count decayed to 0. Later edges of the same probe sequence move back into
+ *        the gap, so every edge stays reachable from its first slot without a gap in between
+ */
+static void freeSlot(edge_weight_counts_t *counts, size_t slot) {
+    size_t gap = slot;
+    counts -> nodes[gap][0] = -1;
+    counts -> nodes[gap][1] = -1;
+    for(size_t next = (gap + 1) & (EDGE_WEIGHT_TABLE_SIZE - 1); counts -> nodes[next][0] != -1; next = (next + 1) & (EDGE_WEIGHT_TABLE_SIZE - 1)) {
+        // An edge can only move back if its first slot is not between the gap and itself
+        size_t first = firstSlot(counts -> nodes[next][0], counts -> nodes[next][1]);
+        if(((next - first) & (EDGE_WEIGHT_TABLE_SIZE - 1)) < ((next - gap) & (EDGE_WEIGHT_TABLE_SIZE - 1))) {
+            continue;
+        }
+        counts -> nodes[gap][0] = counts -> nodes[next][0];
+        counts -> nodes[gap][1] = counts -> nodes[next][1];
+        counts -> counts[gap] = counts -> counts[next];
+        counts -> nodes[next][0] = -1;
+        counts -> nodes[next][1] = -1;
+        counts -> counts[next] = 0;
+        gap = next;
+    }
+    --counts -> used;
+}
+
+bool weightsRecordConflict(edge_weight_counts_t *counts, long u, long v) {
+    if(u > v) {
+        long swap = u;
+        u = v;
+        v = swap;
+    }
+
+    size_t slot = firstSlot(u, v);
+    for(int probe = 0; probe < EDGE_WEIGHT_MAX_PROBES; ++probe, slot = (slot + 1) & (EDGE_WEIGHT_TABLE_SIZE - 1)) {
+        if(counts -> nodes[slot][0] == -1) {
+            counts -> nodes[slot][0] = u;
+            counts -> nodes[slot][1] = v;
+            ++counts -> used;
+        } else if(counts -> nodes[slot][0] != u || counts -> nodes[slot][1] != v) {
+            continue;
+        }
+        ++counts -> counts[slot];
+        return true;
+    }
+    return false;
+}
+
+void weightsPublish(edge_weight_counts_t *counts, edge_weight_table_t *table) {
+    uint32_t maxCount = 0;
+    for(size_t slot = 0; slot < EDGE_WEIGHT_TABLE_SIZE; ++slot) {
+        if(counts -> counts[slot] > maxCount) {
+            maxCount = counts -> counts[slot];
+        }
+    }
+    if(maxCount == 0) {
+        return;
+    }
+
+    // An odd sequence tells the generators that the entries are being written
+    uint64_t sequence = table -> sequence;
+    __atomic_store_n(&table -> sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    // Empty slots are written as well, since the slots of the counts change when edges fade out
+    for(size_t slot = 0; slot < EDGE_WEIGHT_TABLE_SIZE; ++slot) {
+        uint64_t scaled = ((uint64_t) counts -> counts[slot] * (EDGE_WEIGHT_MAX - 1) + maxCount / 2) / maxCount;
+        __atomic_store_n(&table -> entries[slot].nodes[0], counts -> nodes[slot][0], __ATOMIC_RELAXED);
+        __atomic_store_n(&table -> entries[slot].nodes[1], counts -> nodes[slot][1], __ATOMIC_RELAXED);
+        __atomic_store_n(&table -> entries[slot].weight, (uint32_t) (1 + scaled), __ATOMIC_RELAXED);
+
+        // Every publication forgets a quarter of the counts, rounded up so single conflicts fade out
+        counts -> counts[slot] -= (counts -> counts[slot] + 3) / 4;
+    }
+
+    __atomic_store_n(&table -> sequence, sequence + 2, __ATOMIC_RELEASE);
+
+    // Edges that faded out give their slots to new ones. A slot is checked again after an edge moved into it
+    for(size_t slot = 0; slot < EDGE_WEIGHT_TABLE_SIZE;) {
+        if(counts -> nodes[slot][0] != -1 && counts -> counts[slot] == 0) {
+            freeSlot(counts, slot);
+        } else {
+            ++slot;
+        }
+    }
+}
+
+/**
+ * @brief Looks up the weight of an edge in the shared table, the smaller id has to come first
+ */
+static uint32_t lookupWeight(const edge_weight_table_t *table, long u, long v) {
+    size_t slot = firstSlot(u, v);
+    for(int probe = 0; probe < EDGE_WEIGHT_MAX_PROBES; ++probe, slot = (slot + 1) & (EDGE_WEIGHT_TABLE_SIZE - 1)) {
+        long first = __atomic_load_n(&table -> entries[slot].nodes[0], __ATOMIC_RELAXED);
+        if(first == -1) {
+            return 1;
+        }
+        if(first == u && __atomic_load_n(&table -> entries[slot].nodes[1], __ATOMIC_RELAXED) == v) {
+            return __atomic_load_n(&table -> entries[slot].weight, __ATOMIC_RELAXED);
+        }
+    }
+    return 1;
+}
+
+bool weightsLoad(const edge_weight_table_t *table, const graph_t *graph, uint8_t *weights, uint64_t *sequence) {
+    uint64_t before = __atomic_load_n(&table -> sequence, __ATOMIC_ACQUIRE);
+    if(before == *sequence || (before & 1) != 0) {
+        return false;
+    }
+
+    for(size_t edge = 0; edge < graph -> numEdges; ++edge) {
+        long u = graph -> nodeIds[graph -> edges[edge][0]];
+        long v = graph -> nodeIds[graph -> edges[edge][1]];
+        uint32_t weight = u < v ? lookupWeight(table, u, v) : lookupWeight(table, v, u);
+        weights[edge] = (uint8_t) (weight < EDGE_WEIGHT_MAX ? weight : EDGE_WEIGHT_MAX);
+    }
+
+    // The copy is only consistent if no publication started in the meantime, otherwise the next call copies again
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if(__atomic_load_n(&table -> sequence, __ATOMIC_RELAXED) != before) {
+        return false;
+    }
+    *sequence = before;
+    return true;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file weights.h
+ * @author Simon Buchinger 12220026 <e12220026@student.tuwien.ac.at>
+ * @date 18.10.2026
+ * @program: 3coloring
+ *
+ * @brief Headder file for the edge weights shared between the supervisor and the generators
+ * @details The supervisor counts how often every edge is among the conflicts of a result and every
+ *          EDGE_WEIGHT_PUBLISH_RESULTS results publishes the counts as weights from 1 to EDGE_WEIGHT_MAX, scaled by
+ *          the largest count. Every publication also decays the counts, so the weights follow the edges that are
+ *          hard to satisfy right now. The generators copy the weights of their edges into an array the kernel walk
+ *          minimises, in the manner of breakout local search. Parallel tempering keeps counting plain conflicts.
+ *
+ **/
+
+#ifndef WEIGHTS_H_FILE
+#define WEIGHTS_H_FILE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "commons.h"
+#include "graph.h"
+
+/**
+ * @brief Number of results between two publications of the weights
+ */
+#define EDGE_WEIGHT_PUBLISH_RESULTS 8
+
+/**
+ * @brief Longest probe sequence of the table. Edges that do not fit keep weight 1
+ */
+#define EDGE_WEIGHT_MAX_PROBES 64
+
+/**
+ * @brief Conflict counts of the supervisor. An edge has the same slot here and in the shared table
+ *
+ */
+typedef struct {
+    long nodes[EDGE_WEIGHT_TABLE_SIZE][2];
+    uint32_t counts[EDGE_WEIGHT_TABLE_SIZE];
+    size_t used;
+} edge_weight_counts_t;
+
+/**
+ * @brief Clears the counts and the shared table. Generators that copied weights before copy the cleared ones again
+ *
+ * @param counts The counts of the supervisor
+ * @param table The shared table
+ */
+void weightsReset(edge_weight_counts_t *counts, edge_weight_table_t *table);
+
+/**
+ * @brief Counts one conflict of an edge
+ *
+ * @param counts The counts of the supervisor
+ * @param u Id of one node
+ * @param v Id of the other node
+ * @return false if the table has no room for the edge
+ */
+bool weightsRecordConflict(edge_weight_counts_t *counts, long u, long v);
+
+/**
+ * @brief Writes the normalised counts into the shared table, decays the counts and frees the slots of the edges
+ *        whose count reached 0
+ *
+ * @param counts The counts of the supervisor
+ * @param table The shared table
+ */
+void weightsPublish(edge_weight_counts_t *counts, edge_weight_table_t *table);
+
+/**
+ * @brief Copies the weights of all edges of a graph from the shared table if they were published since the last call
+ *
+ * @param table The shared table
+ * @param graph The graph
+ * @param weights Output for one weight per edge of the graph, partly overwritten if a publication overlapped the copy
+ * @param sequence Sequence of the last copied publication, only updated if the copy succeeded
+ * @return true if the weights were rewritten consistently, false if nothing was published since the last copy or a
+ *         publication was in progress or overlapped the copy
+ */
+bool weightsLoad(const edge_weight_table_t *table, const graph_t *graph, uint8_t *weights, uint64_t *sequence);
+
+#endif